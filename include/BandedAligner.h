@@ -0,0 +1,73 @@
+#ifndef BANDEDALIGNER_H
+#define BANDEDALIGNER_H
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * Classe BandedAligner
+ *
+ * Alignement local à pénalités de gap affines (Smith-Waterman / Gotoh) restreint à une
+ * bande de diagonales autour d'une diagonale attendue (celle de la graine), avec trace
+ * arrière : score, positions alignées, CIGAR (M, I, D et S pour les extrémités écrêtées)
+ * et vraie distance d'édition.
+ *
+ * Comme dans BWA-MEM, écrêter une extrémité du read coûte clipPenalty : un read
+ * entier est préféré à un alignement local à peine meilleur.
+ *
+ * La matrice est parcourue par anti-diagonales : les cellules d'une anti-diagonale sont
+ * indépendantes et sont calculées par 16 (entiers 16 bits, AVX2 détecté à l'exécution) ;
+ * une version scalaire donne exactement les mêmes résultats sur les autres processeurs.
+ */
+class BandedAligner {
+public:
+    // Scores de BWA-MEM (match 1, mismatch 4, ouverture 6, extension 1, écrêtage 5) ;
+    // une base non-ACGT coûte 1
+    struct Scoring {
+        int match = 1;
+        int mismatch = 4;
+        int gapOpen = 6;
+        int gapExtend = 1;
+        int clipPenalty = 5;
+    };
+
+    struct Alignment {
+        int score = 0;
+        std::size_t queryStart = 0;   // première base alignée du read
+        std::size_t queryEnd = 0;     // après la dernière base alignée
+        std::size_t targetStart = 0;  // idem dans la cible
+        std::size_t targetEnd = 0;
+        std::string cigar;            // dans le sens de la cible, écrêtage compris
+        int editDistance = 0;         // mismatches + bases insérées + bases supprimées
+    };
+
+    static constexpr std::size_t DEFAULT_BAND_WIDTH = 15;
+
+    // Scores par défaut, bande de DEFAULT_BAND_WIDTH diagonales de part et d'autre
+    BandedAligner();
+    // Lève std::invalid_argument si un score est négatif ou si match vaut 0
+    explicit BandedAligner(const Scoring& scoring, std::size_t bandWidth = DEFAULT_BAND_WIDTH);
+
+    /**
+     * Aligne query sur target dans la bande j - i ∈ [diagonal - w, diagonal + w]
+     * (i position dans query, j dans target). Lève std::invalid_argument si le read
+     * est trop long pour des scores sur 16 bits (voir canAlign).
+     */
+    Alignment align(std::string_view query, std::string_view target, long diagonal) const;
+
+    // Vrai si un read de cette longueur tient dans des scores sur 16 bits
+    bool canAlign(std::size_t queryLength) const;
+
+    // Désactive la version vectorisée (comparaison dans les tests)
+    void setVectorized(bool enabled) { vectorized = enabled; }
+
+    const Scoring& getScoring() const { return scoring; }
+    std::size_t getBandWidth() const { return bandWidth; }
+
+private:
+    Scoring scoring;
+    std::size_t bandWidth;
+    bool vectorized = true;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef FMINDEX_H
+#define FMINDEX_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "IndexFile.h"
+#include "IndexArray.h"
+#include "PackedSequence.h"
+#include "SuffixArray.h"
+
+/**
+ * Classe FMIndex
+ *
+ * Index FM construit à partir d'une table des suffixes : transformée de
+ * Burrows-Wheeler (BWT), table des occurrences et échantillon de la table SA.
+ * Le comptage d'un motif de longueur m se fait par recherche arrière en O(m),
+ * indépendamment de la taille du génome ; la localisation remonte la BWT (LF)
+ * jusqu'à une position échantillonnée (au plus sampleRate - 1 pas).
+ *
+ * Disposition mémoire :
+ *  - la BWT est stockée sur 2 bits par symbole dans des blocs de 64 octets
+ *    (une ligne de cache) : 4 compteurs 32 bits (A, C, G, T avant le bloc, relatifs
+ *    au super-bloc) suivis de 192 symboles. Un rang se calcule avec une seule
+ *    ligne de cache et quelques popcount ;
+ *  - des super-blocs de compteurs 64 bits toutes les 2^16 lignes ;
+ *  - la sentinelle '$' et les bases non-ACGT ('N') sont codées comme 'A' dans la BWT
+ *    et corrigées par une table triée d'exceptions (rares en pratique) ;
+ *  - les rangs des positions multiples de sampleRate sont marqués dans un vecteur
+ *    de bits (blocs de 64 octets avec rang cumulé) et leurs positions stockées
+ *    (divisées par sampleRate) dans un IndexArray.
+ *
+ * Pour une référence de n bases avec sampleRate = 16 : environ 0,98 octet par base
+ * (BWT 0,33, texte compacté 0,25, échantillons de SA sur 4 octets 0,25, vecteur de
+ * bits des échantillons 0,14), contre ~5,3 octets pour la table SA + LCP.
+ * Comme SuffixArray, les tables peuvent appartenir à l'objet ou être des vues
+ * sur un index projeté en mémoire.
+ */
+class FMIndex {
+public:
+    static constexpr std::size_t BASES_PER_BLOCK = 192;
+    static constexpr std::size_t SUPERBLOCK_SHIFT = 16;     // 2^16 blocs par super-bloc
+    static constexpr std::size_t SAMPLE_BITS_PER_BLOCK = 448;
+    static constexpr unsigned DEFAULT_SAMPLE_RATE = 16;
+
+    // Bloc de la table des occurrences (une ligne de cache)
+    struct alignas(64) OccBlock {
+        std::uint32_t counts[4];  // A, C, G, T avant le bloc, depuis le début du super-bloc
+        std::uint64_t bases[6];   // 192 symboles sur 2 bits
+    };
+
+    struct SuperBlock {
+        std::uint64_t counts[4];
+    };
+
+    // Bloc du vecteur de bits des rangs échantillonnés (une ligne de cache)
+    struct alignas(64) SampleBlock {
+        std::uint64_t rank;       // nombre de rangs échantillonnés avant le bloc
+        std::uint64_t bits[7];
+    };
+
+    // Paramètres scalaires, écrits dans la section FM_HEADER
+    struct Header {
+        std::uint64_t textLength;      // sentinelle comprise
+        std::uint64_t dollarRow;       // rang dont le symbole BWT est '$'
+        std::uint64_t sampleRate;
+        std::uint64_t firstRank[6];    // premier rang des suffixes commençant par A, C, G, T, N, $
+    };
+
+private:
+    std::shared_ptr<const MappedFile> mapping;
+
+    PackedSequence sequence;
+    Header header{};
+
+    std::vector<OccBlock> blockStorage;
+    std::vector<SuperBlock> superStorage;
+    std::vector<std::uint64_t> exceptionStorage; // rangs BWT dont le symbole est 'N'
+    std::vector<SampleBlock> sampleBitStorage;
+    const OccBlock* blocks = nullptr;
+    const SuperBlock* superBlocks = nullptr;
+    const std::uint64_t* exceptions = nullptr;
+    const SampleBlock* sampleBits = nullptr;
+    std::size_t blockCount = 0;
+    std::size_t exceptionCount = 0;
+    std::size_t sampleBlockCount = 0;
+    IndexArray samples;
+
+    FMIndex() = default;
+
+    void publish();
+
+    // Nombre d'exceptions ('N') de rang < i
+    std::size_t exceptionsBefore(std::size_t i) const;
+
+    // Symbole BWT du rang r : 0..3 pour ACGT, 4 pour 'N', 5 pour '$'
+    unsigned symbolAt(std::size_t r) const;
+
+    // Nombre d'occurrences du symbole (0..5) dans BWT[0, i)
+    std::size_t occ(unsigned symbol, std::size_t i) const;
+
+    // Correspondance LF : rang du suffixe qui commence une position plus tôt
+    std::size_t lf(std::size_t r) const {
+        unsigned symbol = symbolAt(r);
+        return header.firstRank[symbol] + occ(symbol, r);
+    }
+
+    bool isSampled(std::size_t r) const {
+        const SampleBlock& block = sampleBits[r / SAMPLE_BITS_PER_BLOCK];
+        std::size_t bit = r % SAMPLE_BITS_PER_BLOCK;
+        return (block.bits[bit / 64] >> (bit % 64)) & 1u;
+    }
+
+    std::size_t sampleRank(std::size_t r) const;
+
+public:
+    // Construit l'index à partir d'une table des suffixes fraîchement construite,
+    // dont la référence compactée est reprise (la table SA est ensuite inutile)
+    static FMIndex fromSuffixArray(SuffixArray&& suffixArray,
+                                   unsigned sampleRate = DEFAULT_SAMPLE_RATE);
+
+    // Les vues internes pointent dans les tampons : copie interdite, déplacement autorisé
+    FMIndex(const FMIndex&) = delete;
+    FMIndex& operator=(const FMIndex&) = delete;
+    FMIndex(FMIndex&&) = default;
+    FMIndex& operator=(FMIndex&&) = default;
+
+    // Ajoute les sections PACKED_TEXT, N_RUNS et FM_* à un index en cours d'écriture
+    void save(IndexFile::Writer& writer) const;
+
+    // Recharge les tables depuis un index projeté en mémoire (sans copie)
+    static FMIndex load(const IndexFile::Reader& reader);
+
+    // Intervalle [début, fin) des rangs des suffixes préfixés par le motif (recherche arrière)
+    std::pair<std::size_t, std::size_t> findInterval(std::string_view motif) const;
+
+    // Position dans le texte du suffixe de rang r
+    std::size_t locate(std::size_t r) const;
+    std::size_t positionAt(std::size_t r) const { return locate(r); }
+
+    bool search(const std::string& motif) const { return countOccurrences(motif) > 0; }
+    std::size_t countOccurrences(const std::string& motif) const;
+    std::vector<std::size_t> findOccurrences(const std::string& motif) const;
+
+    const PackedSequence& getSequence() const { return sequence; }
+    std::size_t getReferenceLength() const { return header.textLength; }
+    unsigned getSampleRate() const { return static_cast<unsigned>(header.sampleRate); }
+
+    // Mémoire utilisée par les tables (octets), texte compacté compris
+    std::size_t memoryBytes() const;
+};
+
+#endif
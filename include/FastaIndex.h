@@ -0,0 +1,57 @@
+#ifndef FASTAINDEX_H
+#define FASTAINDEX_H
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Une ligne du fichier .fai (format samtools faidx)
+struct FastaIndexEntry {
+    std::string name;        // en-tête sans '>', jusqu'au premier blanc
+    std::size_t length;      // nombre de bases
+    std::uint64_t offset;    // position (octets) de la première base dans le fichier
+    std::size_t lineBases;   // bases par ligne
+    std::size_t lineWidth;   // octets par ligne, fin de ligne comprise
+};
+
+/**
+ * Classe FastaIndex
+ *
+ * Index .fai d'un fichier FASTA, compatible avec samtools faidx : pour chaque séquence, son
+ * nom, sa longueur, la position de sa première base et la géométrie de ses lignes. Toutes
+ * les lignes d'une séquence sauf la dernière doivent avoir la même longueur : la base i se
+ * trouve alors à offset + (i / lineBases) * lineWidth + i % lineBases, sans relire le fichier.
+ */
+class FastaIndex {
+public:
+    FastaIndex() = default;
+
+    /**
+     * Parcourt le fichier FASTA (projeté en mémoire) et construit l'index.
+     * Lève std::runtime_error si le fichier ne s'ouvre pas, ne commence pas par un en-tête
+     * '>' ou si les lignes d'une séquence n'ont pas toutes la même longueur.
+     */
+    static FastaIndex build(const std::string& fastaPath);
+
+    // Lit un fichier .fai ; lève std::runtime_error s'il ne s'ouvre pas ou est mal formé
+    static FastaIndex load(const std::string& indexPath);
+
+    // Écrit l'index au format .fai ; lève std::runtime_error en cas d'échec
+    void save(const std::string& indexPath) const;
+
+    const std::vector<FastaIndexEntry>& getEntries() const { return entries; }
+    bool contains(const std::string& name) const { return positions.count(name) > 0; }
+
+    // Entrée de la séquence name ; lève std::invalid_argument si elle n'existe pas
+    const FastaIndexEntry& find(const std::string& name) const;
+
+private:
+    std::vector<FastaIndexEntry> entries;
+    std::unordered_map<std::string, std::size_t> positions; // nom -> rang dans entries
+
+    // Ajoute une entrée ; lève std::runtime_error si le nom est déjà présent
+    void add(FastaIndexEntry entry);
+};
+
+#endif
@@ -5,6 +5,10 @@
 #include <vector>  // Pour utiliser std::vector (tableaux dynamiques)
 #include "SequenceParser.h" // Ensure the correct case matches the file name
 #include <functional> // Pour utiliser std::function
+#include <memory>
+#include "RecordBatch.h"
+#include "FastaIndex.h"
+#include "MappedFile.h"
 
 // Définition de la classe FastaParser pour analyser des fichiers au format FASTA
 class FastaParser : public SequenceParser{
@@ -12,6 +16,8 @@ private:
     // Membres privés : uniquement accessibles à l'intérieur de la classe
     std::string filePath;                // Chemin vers le fichier FASTA
     mutable bool isStreamMode = false; 
+    std::unique_ptr<FastaIndex> index;     // index .fai, chargé par loadIndex
+    std::unique_ptr<MappedFile> mapping;   // fichier projeté pour fetch
 
 public:
     // Constructeur : initialise un objet avec le chemin du fichier
@@ -43,6 +49,39 @@ public:
     bool processSequences(
         const std::function<void(const std::string& header,
                                  const std::string& sequence)>& callback);
+
+    // Index .fai (samtools faidx) : lu dans filePath + ".fai" s'il existe et n'est pas plus
+    // ancien que le FASTA, construit sinon (sans être écrit). Lève std::runtime_error pour un
+    // fichier compressé ou dont les lignes d'une séquence n'ont pas la même longueur
+    const FastaIndex& loadIndex();
+
+    // Construit l'index et l'écrit dans filePath + ".fai"
+    void writeIndex();
+
+    // Bases [start, end) (à partir de 0, end borné à la longueur) de la séquence contig, lues
+    // à leur position dans le fichier projeté, sans charger le reste ; l'index est chargé au
+    // premier appel. Lève std::invalid_argument si contig est inconnu ou si start > end
+    std::string fetch(const std::string& contig, std::size_t start, std::size_t end);
+
+    // Même lecture, les séquences rangées dans des lots pris dans pool (qualités vides) ;
+    // chaque lot plein, puis le dernier, est passé à callback(std::unique_ptr<RecordBatch>&&)
+    template <typename Callback>
+    bool forEachBatch(RecordBatchPool& pool, Callback&& callback) {
+        std::unique_ptr<RecordBatch> batch = pool.acquire();
+        const bool complete = processSequences([&](const std::string& header, const std::string& sequence) {
+            batch->add(header, sequence, std::string_view());
+            if (batch->isFull()) {
+                callback(std::move(batch));
+                batch = pool.acquire();
+            }
+        });
+        if (batch->size() > 0) {
+            callback(std::move(batch));
+        } else {
+            pool.release(std::move(batch));
+        }
+        return complete;
+    }
     
 
 };
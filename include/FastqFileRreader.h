@@ -1,6 +1,9 @@
 #ifndef FASTQFILEREADER_H
 #define FASTQFILEREADER_H
 #include "SequenceParser.h"
+#include "FastqScanner.h"
+#include "GzipReader.h"
+#include "RecordBatch.h"
 #include <string>
 #include <vector>
 #include <fstream>
@@ -18,6 +21,12 @@ private:
      */
     mutable bool isStreamMode = false;
 
+    // Flux de lecture enregistrement par enregistrement (nextRecord), ouvert au premier appel
+    std::unique_ptr<InputFile> recordStream;
+
+    // Threads de décompression d'un fichier BGZF
+    unsigned numThreads = 1;
+
     /**
      * Vérifie si la ligne courante est un début de séquence FASTQ (commence par '@')
      */
@@ -33,6 +42,12 @@ private:
      */
     void parseQualityScores(std::ifstream& file, size_t sequenceLength);
 
+    /**
+     * Lit l'enregistrement suivant du flux (les lignes avant un '@' sont ignorées)
+     * @return false en fin de fichier ou si l'enregistrement est incomplet
+     */
+    bool readRecord(std::istream& in, std::string& header, std::string& sequence, std::string& quality) const;
+
     /**
     *@note Vérifie si les scores de qualité fichier FASTQ sont valide
     *@return true si la lettre est valide et false sinon
@@ -64,6 +79,9 @@ const std::vector<std::string>& getQualityScores();
 
 size_t countSequences() const override;
 
+// Les fichiers .gz sont décompressés à la lecture ; un fichier BGZF par numThreads threads
+void setDecompressionThreads(unsigned threads) { numThreads = threads == 0 ? 1 : threads; }
+
 // Nouvelle méthode stream
 /**
  * processSequences permet de lire un fichier FASTQ en mode stream (sans charger le fichier en mémoire)
@@ -76,6 +94,63 @@ bool processSequences(
                            const std::string& sequence,
                            const std::string& quality)>& callback);
 
+/**
+ * nextRecord lit un enregistrement à la fois (mode stream) : deux lecteurs peuvent ainsi
+ * avancer au même pas sur les fichiers R1 et R2 d'une bibliothèque paired-end.
+ * @return false en fin de fichier ; lève std::runtime_error si le fichier ne s'ouvre pas
+ */
+bool nextRecord(std::string& header, std::string& sequence, std::string& quality);
+
+/**
+ * forEachRecord lit le fichier sans copie (FastqScanner : projection mmap, ou read(2) par
+ * blocs pour un tube ou "-") et appelle callback(header, sequence, quality) avec des
+ * std::string_view valides uniquement pendant l'appel.
+ * @return le nombre d'enregistrements ; lève std::runtime_error si le fichier ne s'ouvre pas
+ */
+template <typename Callback>
+std::size_t forEachRecord(Callback&& callback) {
+    isStreamMode = true;
+    return FastqScanner(filePath, numThreads).forEachRecord(std::forward<Callback>(callback));
+}
+
+/**
+ * forEachBatch range les enregistrements dans des lots pris dans pool et passe chaque lot
+ * plein (puis le dernier, incomplet) à callback(std::unique_ptr<RecordBatch>&&) ; le
+ * destinataire rend le lot à pool une fois traité (MappingPipeline::runRecordBatches).
+ * @return le nombre d'enregistrements
+ */
+template <typename Callback>
+std::size_t forEachBatch(RecordBatchPool& pool, Callback&& callback) {
+    std::unique_ptr<RecordBatch> batch = pool.acquire();
+    const std::size_t count = forEachRecord([&](std::string_view header, std::string_view sequence,
+                                                std::string_view quality) {
+        batch->add(header, sequence, quality);
+        if (batch->isFull()) {
+            callback(std::move(batch));
+            batch = pool.acquire();
+        }
+    });
+    if (batch->size() > 0) {
+        callback(std::move(batch));
+    } else {
+        pool.release(std::move(batch));
+    }
+    return count;
+}
+
+/**
+ * forEachRecordParallel découpe le fichier en tranches lues par numThreads threads ; chaque
+ * tranche est recalée sur le premier enregistrement valide (en-tête '@', séparateur '+',
+ * qualités de la longueur de la séquence). callback(ordinal, header, sequence, quality) est
+ * appelé en parallèle ; ordinal, le rang de l'enregistrement dans le fichier, permet de
+ * remettre les résultats dans l'ordre.
+ */
+template <typename Callback>
+std::size_t forEachRecordParallel(Callback&& callback, unsigned numThreads) {
+    isStreamMode = true;
+    return FastqScanner(filePath, numThreads).forEachRecordParallel(std::forward<Callback>(callback), numThreads);
+}
+
 
                         
 };
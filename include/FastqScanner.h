@@ -0,0 +1,239 @@
+#ifndef FASTQSCANNER_H
+#define FASTQSCANNER_H
+#include "MappedFile.h"
+#include "GzipReader.h"
+#include "FormatFileDetector.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+/**
+ * Classe FastqScanner
+ *
+ * Lecture FASTQ sans copie : les enregistrements sont découpés directement dans l'entrée
+ * et passés au callback sous forme de std::string_view (en-tête, séquence, qualités),
+ * valides uniquement pendant l'appel.
+ *  - fichier régulier : projection en mémoire (MappedFile), le fichier entier est découpé
+ *    en une seule passe ;
+ *  - tube, FIFO ou entrée standard ("-") : lecture par blocs de READ_BUFFER_SIZE octets avec
+ *    read(2) ; l'enregistrement coupé en fin de bloc est recopié en tête du bloc suivant ;
+ *  - fichier gzip ou BGZF : même lecture par blocs, à la sortie de GzipReader (blocs BGZF
+ *    décompressés par numThreads threads).
+ * Les fins de ligne sont cherchées avec memchr (vectorisé par la libc), un '\r' final
+ * (fichiers CRLF) est retiré. Mêmes règles que FastqFileReader::processSequences : les
+ * lignes avant un '@' sont ignorées, un enregistrement incomplet en fin de fichier aussi.
+ *
+ * forEachRecordParallel découpe un fichier projeté en tranches d'octets lues par plusieurs
+ * threads (OpenMP). Le début d'une tranche est recalé sur le premier enregistrement valide
+ * (findRecordStart) ; une première passe compte les enregistrements de chaque tranche, une
+ * somme préfixe donne le numéro du premier, et la seconde passe découpe les tranches en
+ * parallèle en passant à chaque enregistrement son numéro d'ordre global.
+ */
+class FastqScanner {
+public:
+    static constexpr std::size_t READ_BUFFER_SIZE = 4 << 20;
+    // Taille des tranches du mode parallèle
+    static constexpr std::size_t PARALLEL_CHUNK_SIZE = 8 << 20;
+
+    // numThreads : threads de décompression d'un fichier BGZF
+    explicit FastqScanner(const std::string& filePath, unsigned numThreads = 1);
+
+    /**
+     * Appelle callback(header, sequence, quality) pour chaque enregistrement, dans l'ordre
+     * du fichier. Lève std::runtime_error si le fichier ne s'ouvre pas ou ne se lit pas.
+     * @return le nombre d'enregistrements lus
+     */
+    template <typename Callback>
+    std::size_t forEachRecord(Callback&& callback) const;
+
+    /**
+     * Découpe les enregistrements complets de [begin, end) et les passe au callback.
+     * atEnd : la fin du tampon est la fin de l'entrée (la dernière ligne peut alors ne pas
+     * se terminer par '\n').
+     * @return le début du premier enregistrement incomplet (end si tout a été consommé)
+     */
+    template <typename Callback>
+    static const char* scanRecords(const char* begin, const char* end, bool atEnd, Callback& callback);
+
+    /**
+     * Comme forEachRecord, mais les tranches du fichier sont découpées par numThreads threads :
+     * callback(ordinal, header, sequence, quality) est appelé en parallèle (dans l'ordre du
+     * fichier au sein d'une tranche), ordinal étant le rang de l'enregistrement dans le
+     * fichier. Une entrée non projetable (tube, "-", fichier compressé) est lue séquentiellement.
+     * @return le nombre d'enregistrements lus
+     */
+    template <typename Callback>
+    std::size_t forEachRecordParallel(Callback&& callback, unsigned numThreads,
+                                      std::size_t chunkSize = PARALLEL_CHUNK_SIZE) const;
+
+    /**
+     * Premier début d'enregistrement à partir de from (begin : début du fichier) : une ligne
+     * '@', une ligne de séquence, une ligne séparateur ("+" ou "+" suivi du nom de l'en-tête)
+     * puis une ligne de qualités de même longueur que la séquence. Une ligne de qualités qui
+     * commence par '@' est ainsi écartée. Retourne end si aucun enregistrement ne commence.
+     */
+    static const char* findRecordStart(const char* begin, const char* from, const char* end);
+
+    // Ligne suivante à partir de cursor (sans '\n' ni '\r' final) ; false si elle n'est pas complète
+    static bool nextLine(const char*& cursor, const char* end, bool atEnd, std::string_view& line) {
+        if (cursor >= end) return false;
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+        if (newline == nullptr) {
+            if (!atEnd) return false;
+            newline = end;
+        }
+        line = std::string_view(cursor, static_cast<std::size_t>(newline - cursor));
+        cursor = newline == end ? end : newline + 1;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return true;
+    }
+
+private:
+    std::string filePath;
+    unsigned numThreads;
+
+    // Descripteur de l'entrée non projetable, fermé à la destruction
+    class Descriptor {
+    public:
+        explicit Descriptor(const std::string& filePath);
+        ~Descriptor();
+        Descriptor(const Descriptor&) = delete;
+        Descriptor& operator=(const Descriptor&) = delete;
+        // Lit au plus size octets ; 0 en fin d'entrée, std::runtime_error en cas d'erreur
+        std::size_t read(char* buffer, std::size_t size);
+    private:
+        int fd = -1;
+        bool ownsDescriptor = false;
+        std::string filePath;
+    };
+
+    // Vrai pour un fichier régulier non compressé (projetable) ; "-" désigne l'entrée standard
+    bool isMappable() const;
+
+    // Lecture par blocs de input (Descriptor ou GzipReader) ; les enregistrements coupés
+    // en fin de bloc sont recopiés en tête du bloc suivant
+    template <typename Input, typename Callback>
+    static void scanStream(Input& input, Callback& onRecord);
+};
+
+template <typename Callback>
+const char* FastqScanner::scanRecords(const char* begin, const char* end, bool atEnd, Callback& callback) {
+    const char* cursor = begin;
+    std::string_view header, sequence, separator, quality;
+    for (;;) {
+        const char* recordStart = cursor;
+        do {
+            recordStart = cursor;
+            if (!nextLine(cursor, end, atEnd, header)) return atEnd ? end : recordStart;
+        } while (header.empty() || header[0] != '@');
+
+        if (!nextLine(cursor, end, atEnd, sequence) || !nextLine(cursor, end, atEnd, separator) ||
+            !nextLine(cursor, end, atEnd, quality)) {
+            return atEnd ? end : recordStart;
+        }
+        callback(header, sequence, quality);
+    }
+}
+
+template <typename Callback>
+std::size_t FastqScanner::forEachRecord(Callback&& callback) const {
+    std::size_t count = 0;
+    auto onRecord = [&](std::string_view header, std::string_view sequence, std::string_view quality) {
+        ++count;
+        callback(header, sequence, quality);
+    };
+
+    if (isMappable()) {
+        MappedFile mapping(filePath);
+        mapping.adviseSequential();
+        const char* data = mapping.getData();
+        scanRecords(data, data + mapping.getSize(), true, onRecord);
+    } else if (FormatFileDetector::detectCompression(filePath) != FormatFileDetector::NONE) {
+        GzipReader input(filePath, numThreads);
+        scanStream(input, onRecord);
+    } else {
+        Descriptor input(filePath);
+        scanStream(input, onRecord);
+    }
+    return count;
+}
+
+template <typename Input, typename Callback>
+void FastqScanner::scanStream(Input& input, Callback& onRecord) {
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    std::size_t filled = 0;
+    for (;;) {
+        // Enregistrement plus long que le tampon : le tampon grandit
+        if (filled == buffer.size()) buffer.resize(buffer.size() * 2);
+        const std::size_t received = input.read(buffer.data() + filled, buffer.size() - filled);
+        filled += received;
+        const bool atEnd = received == 0;
+        const char* stop = scanRecords(buffer.data(), buffer.data() + filled, atEnd, onRecord);
+        if (atEnd) return;
+        const std::size_t remaining = static_cast<std::size_t>(buffer.data() + filled - stop);
+        std::memmove(buffer.data(), stop, remaining);
+        filled = remaining;
+    }
+}
+
+template <typename Callback>
+std::size_t FastqScanner::forEachRecordParallel(Callback&& callback, unsigned numThreads,
+                                                std::size_t chunkSize) const {
+    if (!isMappable()) {
+        std::size_t ordinal = 0;
+        return forEachRecord([&](std::string_view header, std::string_view sequence, std::string_view quality) {
+            callback(ordinal++, header, sequence, quality);
+        });
+    }
+
+    MappedFile mapping(filePath);
+    mapping.adviseSequential();
+    const char* data = mapping.getData();
+    const char* end = data + mapping.getSize();
+    const std::size_t chunkCount = mapping.getSize() / std::max<std::size_t>(chunkSize, 1) + 1;
+    const long chunks = static_cast<long>(chunkCount);
+
+    // Bornes des tranches recalées : la tranche i couvre [starts[i], starts[i + 1])
+    std::vector<const char*> starts(chunkCount + 1, end);
+    starts[0] = data;
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+    for (long i = 1; i < chunks; ++i) {
+        starts[i] = findRecordStart(data, data + i * chunkSize, end);
+    }
+
+    // Première passe : nombre d'enregistrements par tranche, puis numéros du premier de chaque tranche
+    std::vector<std::size_t> firstOrdinal(chunkCount + 1, 0);
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+    for (long i = 0; i < chunks; ++i) {
+        std::size_t count = 0;
+        auto countRecord = [&count](std::string_view, std::string_view, std::string_view) { ++count; };
+        scanRecords(starts[i], starts[i + 1], starts[i + 1] == end, countRecord);
+        firstOrdinal[i + 1] = count;
+    }
+    for (std::size_t i = 0; i < chunkCount; ++i) firstOrdinal[i + 1] += firstOrdinal[i];
+
+    // Seconde passe : une exception du callback est relancée après la région parallèle
+    std::vector<std::exception_ptr> errors(chunkCount);
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+    for (long i = 0; i < chunks; ++i) {
+        try {
+            std::size_t ordinal = firstOrdinal[i];
+            auto onRecord = [&](std::string_view header, std::string_view sequence, std::string_view quality) {
+                callback(ordinal++, header, sequence, quality);
+            };
+            scanRecords(starts[i], starts[i + 1], starts[i + 1] == end, onRecord);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return firstOrdinal[chunkCount];
+}
+
+#endif
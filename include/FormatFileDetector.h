@@ -5,10 +5,15 @@
 class FormatFileDetector{
     public:
     enum Format{FASTA, FASTQ, UNKNOWN};
+    enum Compression{NONE, GZIP, BGZF};
     
-    //détecter le format d'un fichier 
+    //détecter le format d'un fichier (après décompression s'il est compressé)
     static Format detect(const std::string& filePath);
 
+    //détecter la compression par les octets magiques : 1f 8b (gzip), avec le sous-champ
+    //extra "BC" pour BGZF ; "-" (entrée standard) n'est pas inspecté
+    static Compression detectCompression(const std::string& filePath);
+
     //convertir le format enum en nom lisible
     static std::string formatToString(Format format);
 
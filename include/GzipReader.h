@@ -0,0 +1,102 @@
+#ifndef GZIPREADER_H
+#define GZIPREADER_H
+#include <string>
+#include <vector>
+#include <istream>
+#include <fstream>
+#include <memory>
+#include <cstdio>
+#include <cstddef>
+#include <zlib.h>
+
+/**
+ * Classe GzipReader
+ *
+ * Décompression en continu d'un fichier gzip (éventuellement fait de plusieurs membres
+ * concaténés). Un fichier BGZF (bgzip, samtools) est une suite de blocs gzip indépendants
+ * d'au plus 64 Ko dont la taille compressée est écrite dans l'en-tête (champ extra "BC") :
+ * les blocs sont lus par lots et décompressés en parallèle par numThreads threads (OpenMP),
+ * puis restitués dans l'ordre ; le CRC32 et la taille de chaque bloc sont vérifiés.
+ * Le format est détecté à l'ouverture (FormatFileDetector::detectCompression).
+ */
+class GzipReader {
+public:
+    // Ouvre filePath ; lève std::runtime_error si le fichier ne s'ouvre pas
+    explicit GzipReader(const std::string& filePath, unsigned numThreads = 1);
+    ~GzipReader();
+
+    GzipReader(const GzipReader&) = delete;
+    GzipReader& operator=(const GzipReader&) = delete;
+
+    /**
+     * Copie au plus size octets décompressés dans buffer.
+     * @return le nombre d'octets copiés, 0 en fin de fichier ; lève std::runtime_error
+     * si le fichier est corrompu ou tronqué
+     */
+    std::size_t read(char* buffer, std::size_t size);
+
+    bool isBlockCompressed() const { return blockCompressed; }
+
+private:
+    // Blocs BGZF décompressés par lot et par thread
+    static constexpr std::size_t BLOCKS_PER_THREAD = 64;
+    static constexpr std::size_t INPUT_BUFFER_SIZE = 1 << 20;
+    static constexpr std::size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
+    std::string filePath;
+    std::FILE* file = nullptr;
+    unsigned numThreads;
+    bool blockCompressed = false;
+    bool finished = false;
+
+    // Octets décompressés pas encore rendus : output[outputPos, output.size())
+    std::vector<char> output;
+    std::size_t outputPos = 0;
+
+    // gzip : flux zlib et tampon d'entrée
+    z_stream stream{};
+    bool streamReady = false;
+    std::vector<unsigned char> input;
+
+    // Remplit output ; false en fin de fichier
+    bool refill();
+    bool refillStream();
+    bool refillBlocks();
+
+    // Lit exactement size octets ; false si le fichier se termine avant le premier octet
+    bool readExactly(unsigned char* target, std::size_t size);
+};
+
+// Tampon de flux au-dessus de GzipReader, pour lire un fichier compressé avec std::getline
+class GzipStreamBuf : public std::streambuf {
+public:
+    explicit GzipStreamBuf(const std::string& filePath, unsigned numThreads = 1);
+
+protected:
+    int_type underflow() override;
+
+private:
+    GzipReader reader;
+    std::vector<char> buffer;
+};
+
+/**
+ * Classe InputFile
+ *
+ * Flux de lecture d'un fichier de séquences, compressé (gzip, BGZF) ou non : remplace
+ * std::ifstream dans les parseurs, la décompression est transparente.
+ */
+class InputFile : public std::istream {
+public:
+    explicit InputFile(const std::string& filePath, unsigned numThreads = 1);
+
+    // Faux si le fichier n'a pas pu être ouvert
+    bool isOpen() const { return open; }
+
+private:
+    std::filebuf fileBuffer;
+    std::unique_ptr<GzipStreamBuf> gzipBuffer;
+    bool open = false;
+};
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef INDEXARRAY_H
+#define INDEXARRAY_H
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring> // Pour std::memcpy
+
+/**
+ * Classe IndexArray
+ *
+ * Tableau d'entiers positifs à largeur variable (4, 5 ou 8 octets par valeur),
+ * utilisé pour la table des suffixes. La largeur est choisie d'après la plus grande
+ * valeur à stocker (widthFor) :
+ *  - 4 octets pour un texte de moins de 2^32 caractères (la moitié de size_t) ;
+ *  - 5 octets (40 bits, jusqu'à 1 To) pour les références plus grandes ;
+ *  - 8 octets au-delà.
+ * Les valeurs sont stockées en petit-boutiste dans un tampon d'octets, qui peut
+ * appartenir à l'objet ou être une vue sur une projection mémoire (index sur disque).
+ */
+class IndexArray {
+private:
+    std::vector<unsigned char> storage; // tampon propre (vide pour une vue)
+    const unsigned char* bytes = nullptr;
+    std::size_t count = 0;
+    unsigned width = 8;
+
+public:
+    IndexArray() = default;
+    // bytes pointe dans storage : copie interdite, déplacement autorisé
+    IndexArray(const IndexArray&) = delete;
+    IndexArray& operator=(const IndexArray&) = delete;
+    IndexArray(IndexArray&&) = default;
+    IndexArray& operator=(IndexArray&&) = default;
+
+    // Largeur minimale (en octets) pour représenter maxValue
+    static unsigned widthFor(std::size_t maxValue) {
+        if (maxValue <= UINT32_MAX) return 4;
+        if (maxValue < (std::uint64_t(1) << 40)) return 5;
+        return 8;
+    }
+
+    // Alloue n valeurs nulles de largeur w
+    void assign(std::size_t n, unsigned w);
+
+    // Vue sans copie sur des données existantes (n valeurs de largeur w)
+    static IndexArray view(const void* data, std::size_t n, unsigned w);
+
+    std::size_t operator[](std::size_t i) const {
+        const unsigned char* p = bytes + i * width;
+        if (width == 4) {
+            std::uint32_t v;
+            std::memcpy(&v, p, 4);
+            return v;
+        }
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, width);
+        return static_cast<std::size_t>(v);
+    }
+
+    void set(std::size_t i, std::size_t value) {
+        std::uint64_t v = value;
+        std::memcpy(storage.data() + i * width, &v, width);
+    }
+
+    // Accès direct au tampon propre, pour les constructions qui écrivent en place
+    unsigned char* mutableData() { return storage.data(); }
+
+    std::size_t size() const { return count; }
+    unsigned getWidth() const { return width; }
+    const unsigned char* data() const { return bytes; }
+    std::size_t sizeBytes() const { return count * width; }
+
+    // Égalité des valeurs (indépendamment de la largeur de stockage)
+    bool operator==(const IndexArray& other) const;
+};
+
+/**
+ * Classe CompactLcpArray
+ *
+ * Table LCP compacte : un octet par entrée ; les valeurs ≥ 255 sont marquées par
+ * 255 et rangées dans une table de débordement triée (position, valeur),
+ * consultée par recherche dichotomique. Sur de l'ADN, la très grande majorité
+ * des LCP sont inférieurs à 255 : la table passe de 8 à ~1 octet par base.
+ */
+class CompactLcpArray {
+public:
+    static constexpr unsigned char OVERFLOW_MARK = 255;
+
+    struct OverflowEntry {
+        std::uint64_t position;
+        std::uint64_t value;
+    };
+
+private:
+    std::vector<unsigned char> smallStorage;
+    std::vector<OverflowEntry> overflowStorage;
+    const unsigned char* small = nullptr;
+    const OverflowEntry* overflow = nullptr;
+    std::size_t count = 0;
+    std::size_t overflowCount = 0;
+
+    std::size_t lookupOverflow(std::size_t i) const;
+
+public:
+    CompactLcpArray() = default;
+    CompactLcpArray(const CompactLcpArray&) = delete;
+    CompactLcpArray& operator=(const CompactLcpArray&) = delete;
+    CompactLcpArray(CompactLcpArray&&) = default;
+    CompactLcpArray& operator=(CompactLcpArray&&) = default;
+
+    // Prépare n entrées nulles ; les valeurs sont ensuite fixées par setValue
+    void resize(std::size_t n);
+
+    // Fixe la valeur i (dans n'importe quel ordre) ; appeler finalize() ensuite
+    void setValue(std::size_t i, std::size_t value) {
+        if (value >= OVERFLOW_MARK) {
+            smallStorage[i] = OVERFLOW_MARK;
+            overflowStorage.push_back({i, value});
+        } else {
+            smallStorage[i] = static_cast<unsigned char>(value);
+        }
+    }
+
+    // Trie la table de débordement et publie les vues
+    void finalize();
+
+    // Vue sans copie sur les sections d'un index projeté
+    static CompactLcpArray view(const unsigned char* smallData, std::size_t n,
+                                const OverflowEntry* overflowData, std::size_t overflowN);
+
+    std::size_t operator[](std::size_t i) const {
+        unsigned char v = small[i];
+        return v != OVERFLOW_MARK ? v : lookupOverflow(i);
+    }
+
+    std::size_t size() const { return count; }
+    const unsigned char* smallData() const { return small; }
+    const OverflowEntry* overflowData() const { return overflow; }
+    std::size_t overflowSize() const { return overflowCount; }
+
+    bool operator==(const CompactLcpArray& other) const;
+};
+
+#endif
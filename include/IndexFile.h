@@ -0,0 +1,125 @@
+#ifndef INDEXFILE_H
+#define INDEXFILE_H
+#include "MappedFile.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Format binaire versionné de l'index (référence compactée, table des suffixes, LCP,
+ * paramètres du k-mer).
+ *
+ * Disposition du fichier :
+ *  - un en-tête fixe (IndexHeader) : nombre magique, version, ordre des octets,
+ *    nombre de sections et métadonnées (k, pas, fenêtre des minimiseurs,
+ *    seuil de masquage des k-mers fréquents) ;
+ *  - un répertoire de sections (IndexSectionEntry) : identifiant, décalage, taille ;
+ *  - les sections elles-mêmes, alignées sur 64 octets pour pouvoir être lues
+ *    directement comme des tableaux depuis la projection mémoire.
+ *
+ * Les tableaux sont écrits dans l'ordre des octets de la machine : un index
+ * construit sur une machine big-endian est refusé au chargement.
+ */
+namespace IndexFile {
+
+    constexpr char MAGIC[8] = {'F', 'A', 'P', 'I', 'I', 'D', 'X', '\0'};
+    constexpr std::uint32_t VERSION = 5;
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    constexpr std::size_t SECTION_ALIGNMENT = 64;
+
+    // Identifiants des sections
+    enum Section : std::uint32_t {
+        PACKED_TEXT = 1,   // référence compactée sur 2 bits (mots de 64 bits)
+        SUFFIX_ARRAY = 2,  // table SA (largeur d'entrée = taille / longueur du texte)
+        LCP = 3,           // table LCP compacte (un octet par entrée)
+        LCP_OVERFLOW = 4,  // débordements de la table LCP (position, valeur)
+        N_RUNS = 5,        // intervalles de bases non-ACGT de la référence
+        PREFIX_TABLE = 6,  // table des q-grammes (facultative, q déduit de la taille)
+        FM_HEADER = 7,     // index FM : paramètres (FMIndex::Header)
+        FM_OCC = 8,        // index FM : BWT et compteurs par blocs de 64 octets
+        FM_SUPERBLOCKS = 9,   // index FM : compteurs 64 bits des super-blocs
+        FM_EXCEPTIONS = 10,   // index FM : rangs BWT dont le symbole est 'N'
+        FM_SAMPLE_BITS = 11,  // index FM : vecteur de bits des rangs échantillonnés
+        FM_SAMPLES = 12,      // index FM : positions échantillonnées (divisées par le taux)
+        KMER_HASH_HEADER = 13,    // table de k-mers : paramètres (KmerHashTable::Header)
+        KMER_HASH_BUCKETS = 14,   // table de k-mers : premier groupe de chaque case
+        KMER_HASH_GROUPS = 15,    // table de k-mers : (code, début) de chaque k-mer distinct
+        KMER_HASH_POSITIONS = 16, // table de k-mers : positions regroupées par k-mer
+        MASKED_KMERS = 17         // codes 2 bits triés des k-mers masqués (trop fréquents)
+    };
+
+    // Métadonnées de l'index k-mer
+    struct Metadata {
+        std::uint64_t kmerSize = 0;
+        std::uint64_t stepSize = 1;
+        std::uint64_t referenceLength = 0; // nombre de bases (sans la sentinelle)
+        std::uint64_t minimizerWindow = 0; // fenêtre w des minimiseurs (0 : tous les k-mers)
+        std::uint64_t maskThreshold = 0;   // k-mers masqués au-delà de ce nombre d'occurrences (0 : aucun)
+    };
+
+    struct IndexHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;
+        std::uint32_t sectionCount;
+        std::uint32_t reserved;
+        Metadata metadata;
+    };
+
+    struct IndexSectionEntry {
+        std::uint32_t id;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    // Vérifie le nombre magique en tête du fichier
+    bool isIndexFile(const std::string& filePath);
+
+    /**
+     * Écriture d'un index : on ajoute les sections (les données doivent rester
+     * valides jusqu'à l'appel de write), puis on écrit le fichier.
+     */
+    class Writer {
+    private:
+        struct PendingSection {
+            Section id;
+            const void* data;
+            std::size_t size;
+        };
+        std::vector<PendingSection> sections;
+
+    public:
+        void addSection(Section id, const void* data, std::size_t size);
+        // Lève std::runtime_error en cas d'erreur d'écriture
+        void write(const std::string& filePath, const Metadata& metadata) const;
+    };
+
+    /**
+     * Lecture d'un index par projection mémoire (lecture seule, pages partagées).
+     * Les vues retournées restent valides tant que la projection (getMapping) est vivante.
+     */
+    class Reader {
+    private:
+        std::shared_ptr<const MappedFile> mapping;
+        Metadata metadata;
+        std::vector<IndexSectionEntry> directory;
+
+    public:
+        // Lève std::runtime_error si le fichier n'est pas un index valide
+        explicit Reader(const std::string& filePath);
+
+        const Metadata& getMetadata() const { return metadata; }
+        const std::shared_ptr<const MappedFile>& getMapping() const { return mapping; }
+
+        bool hasSection(Section id) const;
+        // Octets bruts d'une section ; lève std::runtime_error si elle est absente
+        std::string_view getSection(Section id) const;
+    };
+
+} // namespace IndexFile
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef KMERENCODER_H
+#define KMERENCODER_H
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include "KmerHashTable.h"
+
+/**
+ * Classe KmerEncoder
+ *
+ * Codage glissant des k-mers d'une séquence (k ≤ 32) sur 2 bits par base, première base
+ * en poids fort (comme PackedSequence::packedCode et KmerHashTable). En une seule passe,
+ * chaque position donne le code du k-mer et celui de son complément inverse : le brin
+ * reverse d'un read s'interroge sans construire ni découper la séquence complémentaire.
+ * Les k-mers contenant autre chose que A, C, G, T (majuscules) sont ignorés.
+ */
+class KmerEncoder {
+private:
+    std::size_t kmerSize;
+    std::uint64_t mask;
+    unsigned highShift; // décalage de la première base du k-mer
+
+public:
+    // Lève std::invalid_argument si k n'est pas dans [1, 32]
+    explicit KmerEncoder(std::size_t k) : kmerSize(k) {
+        if (k == 0 || k > KmerHashTable::MAX_KMER_SIZE) {
+            throw std::invalid_argument("Taille de k-mer invalide pour le codage 2 bits (1 à 32)");
+        }
+        mask = k == 32 ? ~std::uint64_t(0) : (std::uint64_t(1) << (2 * k)) - 1;
+        highShift = static_cast<unsigned>(2 * (k - 1));
+    }
+
+    std::size_t getKmerSize() const { return kmerSize; }
+
+    /**
+     * Appelle callback(i, forward, reverse) pour chaque k-mer ACGT de seq, par i croissant :
+     * forward code seq[i, i + k), reverse code son complément inverse, c'est-à-dire le
+     * k-mer en position seq.length() - k - i du complément inverse de seq.
+     */
+    template <typename Callback>
+    void forEach(std::string_view seq, Callback&& callback) const {
+        std::uint64_t forward = 0, reverse = 0;
+        std::size_t valid = 0; // bases ACGT consécutives terminant en i
+        for (std::size_t i = 0; i < seq.length(); ++i) {
+            unsigned base = KmerHashTable::baseCode(seq[i]);
+            if (base > 3) {
+                valid = 0;
+                continue;
+            }
+            forward = ((forward << 2) | base) & mask;
+            reverse = (reverse >> 2) | (std::uint64_t(3 - base) << highShift);
+            if (++valid >= kmerSize) {
+                callback(i + 1 - kmerSize, forward, reverse);
+            }
+        }
+    }
+
+    // Bases du k-mer de code code dans out (k caractères), pour les structures indexées par texte
+    static void decode(std::uint64_t code, std::size_t k, char* out) {
+        for (std::size_t j = k; j-- > 0; code >>= 2) {
+            out[j] = "ACGT"[code & 3];
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef KMERHASHTABLE_H
+#define KMERHASHTABLE_H
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "IndexFile.h"
+#include "IndexArray.h"
+#include "PackedSequence.h"
+
+/**
+ * Classe KmerHashTable
+ *
+ * Table directe k-mer → positions pour k ≤ 32. Chaque k-mer est codé sur un entier
+ * 64 bits (2 bits par base, première base en poids fort, comme PackedSequence::packedCode).
+ * Seules les positions multiples de stepSize sont indexées ou, si une fenêtre w est
+ * donnée, seulement les (w,k)-minimiseurs de la référence (MinimizerSketch) ;
+ * les k-mers contenant une base non-ACGT sont ignorés.
+ *
+ * Disposition (CSR à deux niveaux) :
+ *  - bucketStart : pour chaque case de hachage (puissance de 2, ≥ nombre de k-mers
+ *    distincts), premier groupe de la case ;
+ *  - groups : un groupe (code, début) par k-mer distinct, rangés par case ;
+ *    les positions du groupe g sont positions[groups[g].begin, groups[g + 1].begin) ;
+ *  - positions : positions dans la référence, croissantes à l'intérieur d'un groupe.
+ * Une recherche coûte un hachage, en moyenne un groupe examiné et aucune allocation.
+ *
+ * Comme SuffixArray, les tables peuvent appartenir à l'objet ou être des vues
+ * sur un index projeté en mémoire.
+ */
+class KmerHashTable {
+public:
+    static constexpr std::size_t MAX_KMER_SIZE = 32;
+
+    struct Group {
+        std::uint64_t code;
+        std::uint64_t begin;
+    };
+
+    // Paramètres scalaires, écrits dans la section KMER_HASH_HEADER
+    struct Header {
+        std::uint64_t kmerSize;
+        std::uint64_t stepSize;
+        std::uint64_t windowSize;   // fenêtre des minimiseurs (0 : positions multiples du pas)
+        std::uint64_t bucketCount;  // puissance de 2
+        std::uint64_t groupCount;   // k-mers distincts (plus un groupe sentinelle)
+        std::uint64_t positionCount;
+    };
+
+private:
+    std::shared_ptr<const MappedFile> mapping;
+
+    PackedSequence sequence;
+    Header header{};
+
+    std::vector<Group> groupStorage;
+    const Group* groups = nullptr;
+    IndexArray bucketStart;
+    IndexArray positions;
+
+    KmerHashTable() = default;
+
+    std::size_t bucketOf(std::uint64_t code) const {
+        return static_cast<std::size_t>(mixCode(code) & (header.bucketCount - 1));
+    }
+
+public:
+    // Lève std::invalid_argument si k vaut 0 ou dépasse MAX_KMER_SIZE.
+    // window > 0 : n'indexe que les (w,k)-minimiseurs (le pas est alors ignoré)
+    KmerHashTable(PackedSequence&& reference, std::size_t k, std::size_t step = 1,
+                  std::size_t window = 0);
+
+    // Les vues internes pointent dans les tampons : copie interdite, déplacement autorisé
+    KmerHashTable(const KmerHashTable&) = delete;
+    KmerHashTable& operator=(const KmerHashTable&) = delete;
+    KmerHashTable(KmerHashTable&&) = default;
+    KmerHashTable& operator=(KmerHashTable&&) = default;
+
+    // Ajoute les sections PACKED_TEXT, N_RUNS et KMER_HASH_* à un index en cours d'écriture
+    void save(IndexFile::Writer& writer) const;
+
+    // Recharge les tables depuis un index projeté en mémoire (sans copie)
+    static KmerHashTable load(const IndexFile::Reader& reader);
+
+    // Hachage inversible (finaliseur de MurmurHash3) : répartit les codes voisins
+    static std::uint64_t mixCode(std::uint64_t code) {
+        code ^= code >> 33;
+        code *= 0xff51afd7ed558ccdULL;
+        code ^= code >> 33;
+        code *= 0xc4ceb9fe1a85ec53ULL;
+        code ^= code >> 33;
+        return code;
+    }
+
+    // Code 2 bits d'une base de motif ; 4 pour tout le reste (N, minuscules comprises,
+    // comme dans la recherche par table des suffixes). Une table évite un branchement
+    // imprévisible par base.
+    static unsigned baseCode(char c) {
+        static constexpr auto table = []() {
+            std::array<unsigned char, 256> codes{};
+            codes.fill(4);
+            codes['A'] = 0; codes['C'] = 1; codes['G'] = 2; codes['T'] = 3;
+            return codes;
+        }();
+        return table[static_cast<unsigned char>(c)];
+    }
+
+    // Code 2 bits du k-mer ; faux s'il contient autre chose que A, C, G, T
+    static bool encode(std::string_view kmer, std::uint64_t& code);
+
+    // Intervalle [début, fin) du k-mer dans la table des positions (vide s'il est absent)
+    std::pair<std::size_t, std::size_t> lookup(std::uint64_t code) const;
+
+    // Intervalle du k-mer dans la table des positions ; vide si le motif ne fait pas
+    // exactement k bases ou contient une base non-ACGT
+    std::pair<std::size_t, std::size_t> findInterval(std::string_view kmer) const {
+        std::uint64_t code;
+        if (kmer.length() != header.kmerSize || !encode(kmer, code)) return {0, 0};
+        return lookup(code);
+    }
+
+    std::size_t positionAt(std::size_t i) const { return positions[i]; }
+
+    // Codes (croissants) des k-mers de plus de threshold occurrences estimées : positions
+    // indexées × pas (une position indexée sur stepSize ; 1 en mode minimiseurs)
+    std::vector<std::uint64_t> frequentCodes(std::size_t threshold) const;
+
+    bool search(const std::string& kmer) const { return countOccurrences(kmer) > 0; }
+    // Le motif doit faire exactement k bases (sinon 0 / aucune position)
+    std::size_t countOccurrences(const std::string& kmer) const;
+    std::vector<std::size_t> findOccurrences(const std::string& kmer) const;
+
+    const PackedSequence& getSequence() const { return sequence; }
+    std::size_t getKmerSize() const { return header.kmerSize; }
+    std::size_t getStepSize() const { return header.stepSize; }
+    std::size_t getWindowSize() const { return header.windowSize; }
+
+    // Mémoire utilisée par les tables (octets), texte compacté compris
+    std::size_t memoryBytes() const {
+        return sequence.memoryBytes() + bucketStart.sizeBytes() +
+               header.groupCount * sizeof(Group) + positions.sizeBytes();
+    }
+};
+
+#endif
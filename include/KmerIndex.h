@@ -1,25 +1,133 @@
 #ifndef KMERINDEX_H
 #define KMERINDEX_H
 #include "SuffixArray.h"
+#include "FMIndex.h"
+#include "KmerHashTable.h"
+#include "KmerEncoder.h"
 #include "SequenceParser.h"
 #include <string>
+#include <string_view>
+#include <vector>
 #include <functional>
+#include <variant>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
 #include <cstddef> // Pour size_t
 
+/**
+ * Structure de recherche de l'index.
+ * SUFFIX_ARRAY : table des suffixes + LCP (~5,3 octets par base), recherche dichotomique.
+ * FM_INDEX : BWT + table des occurrences + SA échantillonnée (~1 octet par base),
+ * comptage en O(k) ; la localisation coûte jusqu'à sampleRate pas par occurrence.
+ * HASH_TABLE : table de hachage k-mer → positions (k ≤ 32), recherche en O(1) ;
+ * seules les positions multiples du pas sont indexées, le mapper interroge alors
+ * tous les k-mers du read (getQueryStep).
+ */
+enum class IndexEngine { SUFFIX_ARRAY, FM_INDEX, HASH_TABLE };
+
+/**
+ * Options de construction de l'index (transmises à SuffixArray).
+ * buildMethod : algorithme de construction de la table des suffixes.
+ * numThreads : threads OpenMP utilisés pour la construction (0 = tous).
+ * prefixLength : q de la table des q-grammes qui accélère les recherches
+ *                (-1 = choisi d'après la taille de la référence, 0 = pas de table).
+ * engine : structure de recherche conservée après la construction.
+ * sampleRate : pas d'échantillonnage de la table SA pour FM_INDEX.
+ * minimizerWindow : w > 0 active le mode minimiseurs (w,k) : le mapper n'interroge que
+ *                   les minimiseurs des reads et HASH_TABLE n'indexe que ceux de la
+ *                   référence (index et recherches divisés par ~(w + 1) / 2).
+ * maskThreshold : t > 0 masque les k-mers de plus de t occurrences (k ≤ 32) : leur liste
+ *                 est calculée à la construction et sauvegardée avec l'index, le mapper
+ *                 ne les recherche plus (répétitions du génome). SUFFIX_ARRAY et FM_INDEX
+ *                 comptent toutes les occurrences ; HASH_TABLE n'indexe qu'une position sur
+ *                 step et estime le nombre d'occurrences par positions indexées × step (en
+ *                 mode minimiseurs, les copies d'une répétition ont le même minimiseur : le
+ *                 nombre de positions indexées est gardé tel quel).
+ */
+struct IndexOptions {
+    SuffixArray::BuildMethod buildMethod = SuffixArray::BuildMethod::SAIS;
+    int numThreads = 0;
+    int prefixLength = -1;
+    IndexEngine engine = IndexEngine::SUFFIX_ARRAY;
+    unsigned sampleRate = FMIndex::DEFAULT_SAMPLE_RATE;
+    std::size_t minimizerWindow = 0;
+    std::size_t maskThreshold = 0;
+};
+
 class KmerIndex
 {
 private:
-    const std::string& reference;
     std::size_t kmerSize;
     std::size_t stepSize;
-    SuffixArray suffixArray;
+    std::size_t minimizerWindow;
+    using Engine = std::variant<SuffixArray, FMIndex, KmerHashTable>;
+
+    // Structure de recherche ; possède la référence compactée (PackedSequence)
+    Engine engine;
+
+    // Codes 2 bits triés des k-mers de plus de maskThreshold occurrences (0 : pas de masque)
+    std::size_t maskThreshold;
+    std::vector<std::uint64_t> maskedKmers;
+
+    // constructeur utilisé par load()
+    KmerIndex(Engine&& loadedEngine, std::size_t k, std::size_t step, std::size_t window,
+              std::size_t threshold, std::vector<std::uint64_t>&& masked);
+
+    // Codes des k-mers de plus de threshold occurrences dans la structure de recherche
+    std::vector<std::uint64_t> findFrequentKmers(std::size_t threshold) const;
+
+    static Engine buildEngine(const std::string& referenceGenome, std::size_t k, std::size_t step,
+                              const IndexOptions& options);
+
+    // Intervalle du k-mer de code 2 bits code : la table de hachage est indexée par ce code,
+    // les structures par texte recherchent ses bases décodées (sur la pile)
+    template <typename Structure>
+    static std::pair<std::size_t, std::size_t> intervalOfCode(const Structure& e, std::uint64_t code,
+                                                              std::size_t k) {
+        if constexpr (std::is_same_v<Structure, KmerHashTable>) {
+            return e.lookup(code);
+        } else {
+            char bases[KmerHashTable::MAX_KMER_SIZE];
+            KmerEncoder::decode(code, k, bases);
+            return e.findInterval(std::string_view(bases, k));
+        }
+    }
+
+    // Nombre d'occurrences estimé d'après la largeur d'un intervalle : chaque position de la
+    // table de hachage échantillonnée en représente getStepSize()
+    template <typename Structure>
+    static std::size_t estimatedOccurrences(const Structure& e, std::size_t width) {
+        if constexpr (std::is_same_v<Structure, KmerHashTable>) {
+            return width * e.getStepSize();
+        } else {
+            return width;
+        }
+    }
 
     void processKmersBatch(const std::vector<std::string>& kmers,
                          std::function<void(const std::string&,
                          const std::vector<std::size_t>&)> callback) const;
 
 public:
-    KmerIndex(const std::string& referenceGenome, std::size_t k, std::size_t step = 1);
+    KmerIndex(const std::string& referenceGenome, std::size_t k, std::size_t step = 1,
+              const IndexOptions& options = {});
+
+    /**
+     * Sauvegarde l'index (texte, SA et LCP ou tables FM, k et pas, k-mers masqués) dans un fichier binaire versionné.
+     * Lève std::runtime_error en cas d'erreur d'écriture.
+     */
+    void save(const std::string& indexPath) const;
+
+    /**
+     * Charge un index sauvegardé par save() : les tables sont projetées en mémoire
+     * en lecture seule (mmap), sans reconstruction ni copie.
+     * Lève std::runtime_error si le fichier est absent, corrompu ou d'une autre version.
+     */
+    static KmerIndex load(const std::string& indexPath);
 
     void processSingleRead(const std::string& read,
                           std::function<void(const std::string&,
@@ -27,10 +135,76 @@ public:
 
     std::vector<std::size_t> findKmerPositions(const std::string& kmer) const;
 
+    /**
+     * Intervalle [début, fin) du k-mer dans la structure de recherche, sans allocation :
+     * rangs de la table des suffixes (SUFFIX_ARRAY, FM_INDEX) ou indices de la table
+     * des positions (HASH_TABLE). kmerPositionAt(r) donne la position de chaque rang.
+     */
+    std::pair<std::size_t, std::size_t> findKmerInterval(std::string_view kmer) const {
+        if (kmer.length() != kmerSize)
+            throw std::invalid_argument("Taille de k-mer incorrecte");
+        return std::visit([kmer](const auto& e) { return e.findInterval(kmer); }, engine);
+    }
+
+    std::size_t kmerPositionAt(std::size_t r) const {
+        return std::visit([r](const auto& e) { return e.positionAt(r); }, engine);
+    }
+
+    // Même recherche à partir du code 2 bits du k-mer (KmerEncoder), pour k ≤ 32
+    std::pair<std::size_t, std::size_t> findKmerInterval(std::uint64_t code) const {
+        if (kmerSize > KmerHashTable::MAX_KMER_SIZE)
+            throw std::invalid_argument("Recherche par code 2 bits limitée à k ≤ 32");
+        return std::visit([this, code](const auto& e) { return intervalOfCode(e, code, kmerSize); }, engine);
+    }
+
+    static constexpr std::size_t NO_OCCURRENCE_LIMIT = std::numeric_limits<std::size_t>::max();
+
+    // Appelle callback(position) pour chaque occurrence du k-mer (ordre des rangs),
+    // sans allocation ni copie du k-mer : c'est la recherche utilisée par le mapper.
+    // Au-delà de maxOccurrences occurrences (largeur de l'intervalle, connue avant toute
+    // localisation, multipliée par le pas pour HASH_TABLE), le k-mer est ignoré ; retourne
+    // faux s'il a été ignoré
+    template <typename Callback>
+    bool forEachKmerPosition(std::string_view kmer, Callback&& callback,
+                             std::size_t maxOccurrences = NO_OCCURRENCE_LIMIT) const {
+        if (kmer.length() != kmerSize)
+            throw std::invalid_argument("Taille de k-mer incorrecte");
+        return std::visit([kmer, &callback, maxOccurrences](const auto& e) {
+            auto [lower, upper] = e.findInterval(kmer);
+            if (estimatedOccurrences(e, upper - lower) > maxOccurrences) return false;
+            for (std::size_t r = lower; r < upper; ++r) {
+                callback(e.positionAt(r));
+            }
+            return true;
+        }, engine);
+    }
+
+    // Même parcours par code 2 bits ; un k-mer masqué est ignoré sans recherche
+    template <typename Callback>
+    bool forEachKmerPosition(std::uint64_t code, Callback&& callback,
+                             std::size_t maxOccurrences = NO_OCCURRENCE_LIMIT) const {
+        if (kmerSize > KmerHashTable::MAX_KMER_SIZE)
+            throw std::invalid_argument("Recherche par code 2 bits limitée à k ≤ 32");
+        if (isMasked(code)) return false;
+        return std::visit([this, code, &callback, maxOccurrences](const auto& e) {
+            auto [lower, upper] = intervalOfCode(e, code, kmerSize);
+            if (estimatedOccurrences(e, upper - lower) > maxOccurrences) return false;
+            for (std::size_t r = lower; r < upper; ++r) {
+                callback(e.positionAt(r));
+            }
+            return true;
+        }, engine);
+    }
+
+    // Vrai si le k-mer de code 2 bits code a plus de getMaskThreshold() occurrences
+    bool isMasked(std::uint64_t code) const {
+        return !maskedKmers.empty() && std::binary_search(maskedKmers.begin(), maskedKmers.end(), code);
+    }
+
     std::size_t getKmerSupport(const std::string& kmer) const {
         if (kmer.length() != kmerSize) 
             throw std::invalid_argument("Taille de k-mer invalide");
-        return suffixArray.countOccurrences(kmer);
+        return std::visit([&kmer](const auto& e) { return e.countOccurrences(kmer); }, engine);
     }
 
     std::vector<std::size_t> getKmerPositions(const std::string& kmer, 
@@ -47,9 +221,25 @@ public:
         return findKmerPositions(SequenceParser::getReverseComplement(kmer));
     }
 
-    const std::string& getReference() const { return reference; }
+    // Référence compactée sur 2 bits, partagée avec la structure de recherche
+    const PackedSequence& getReference() const {
+        return std::visit([](const auto& e) -> const PackedSequence& { return e.getSequence(); }, engine);
+    }
+    IndexEngine getEngine() const {
+        if (std::holds_alternative<FMIndex>(engine)) return IndexEngine::FM_INDEX;
+        if (std::holds_alternative<KmerHashTable>(engine)) return IndexEngine::HASH_TABLE;
+        return IndexEngine::SUFFIX_ARRAY;
+    }
     std::size_t getKmerSize() const { return kmerSize; }
     std::size_t getStepSize() const { return stepSize; }
+    // Pas entre deux k-mers interrogés dans un read : le pas de l'index, sauf pour la
+    // table de hachage qui applique déjà le pas à la référence (on interroge alors tout)
+    std::size_t getQueryStep() const { return getEngine() == IndexEngine::HASH_TABLE ? 1 : stepSize; }
+    // Fenêtre w des minimiseurs (0 : mode désactivé)
+    std::size_t getMinimizerWindow() const { return minimizerWindow; }
+    // Seuil de masquage (0 : pas de masque) et nombre de k-mers masqués
+    std::size_t getMaskThreshold() const { return maskThreshold; }
+    std::size_t getMaskedKmerCount() const { return maskedKmers.size(); }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <string>
+#include <cstddef> // Pour size_t
+
+/**
+ * Classe MappedFile
+ *
+ * Projection en mémoire (mmap) d'un fichier en lecture seule.
+ * Les pages sont partagées (MAP_SHARED) : plusieurs processus qui projettent
+ * le même fichier utilisent le même cache de pages du noyau.
+ * La projection est libérée (munmap) à la destruction de l'objet.
+ */
+class MappedFile {
+private:
+    const char* data = nullptr;  // début de la projection
+    std::size_t length = 0;      // taille du fichier en octets
+
+public:
+    // Projette le fichier ; lève std::runtime_error en cas d'échec
+    explicit MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    // Désactive la copie (une seule propriétaire de la projection)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* getData() const { return data; }
+    // Annonce une lecture séquentielle (lecture anticipée plus agressive du noyau)
+    void adviseSequential() const;
+    std::size_t getSize() const { return length; }
+};
+
+#endif
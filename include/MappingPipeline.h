@@ -0,0 +1,111 @@
+#ifndef MAPPINGPIPELINE_H
+#define MAPPINGPIPELINE_H
+#include "ReadMapper.h"
+#include "RecordBatch.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+// Un read lu dans un fichier FASTQ ou FASTA (qualité vide en FASTA)
+struct ReadRecord {
+    std::string header;
+    std::string sequence;
+    std::string quality;
+};
+
+// Une paire de reads lue au même pas dans les fichiers R1 et R2
+struct ReadPair {
+    ReadRecord mate1;
+    ReadRecord mate2;
+};
+
+/**
+ * Classe MappingPipeline
+ *
+ * Mapping multithreadé producteur / consommateurs :
+ *  - un thread lecteur regroupe les reads en lots de batchSize ;
+ *  - numThreads threads de calcul mappent chaque lot d'un bloc (ReadMapper::mapBatch, const) ;
+ *  - le thread appelant écrit les résultats dans l'ordre d'entrée.
+ * Au plus maxBatchesInFlight lots sont lus et pas encore écrits : le lecteur attend
+ * que l'écriture libère une place (contre-pression), la mémoire reste bornée quel
+ * que soit le nombre de reads. Une exception levée par la lecture, le mapping ou
+ * l'écriture arrête le pipeline et est relancée par run().
+ */
+class MappingPipeline {
+public:
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 1024;
+
+    // source(emit) appelle emit(record) pour chaque read, dans l'ordre du fichier
+    using RecordSource = std::function<void(const std::function<void(ReadRecord&&)>& emit)>;
+    // Appelé dans l'ordre d'entrée, depuis le thread qui exécute run()
+    using ResultSink = std::function<void(const ReadRecord& record, const MappingResult& result)>;
+
+    // numThreads = 0 : tous les cœurs (std::thread::hardware_concurrency)
+    // maxBatchesInFlight = 0 : 4 lots par thread de calcul
+    explicit MappingPipeline(const ReadMapper& mapper, unsigned numThreads = 0,
+                             std::size_t batchSize = DEFAULT_BATCH_SIZE,
+                             std::size_t maxBatchesInFlight = 0);
+
+    // Mappe tous les reads de la source ; retourne le nombre de reads traités
+    std::size_t run(const RecordSource& source, const ResultSink& sink) const;
+
+    // Même pipeline en paired-end : chaque lot de paires est mappé par ReadMapper::mapPairs
+    // (distribution des tailles d'insert estimée par lot) ; retourne le nombre de paires
+    using PairSource = std::function<void(const std::function<void(ReadPair&&)>& emit)>;
+    using PairSink = std::function<void(const ReadPair& pair, const PairedMappingResult& result)>;
+    std::size_t runPaired(const PairSource& source, const PairSink& sink) const;
+
+    /**
+     * Variante à formatage parallèle : chaque thread de calcul formate son lot dans un tampon
+     * texte propre au lot (format(record, result, out) ajoute à out), sans verrou ; les
+     * blocs sont passés à write un lot à la fois, dans l'ordre d'entrée, par le seul thread
+     * appelant (SamWriter::formatRecord / writeBlock)
+     */
+    using RecordFormatter = std::function<void(const ReadRecord& record, const MappingResult& result, std::string& out)>;
+    using PairFormatter = std::function<void(const ReadPair& pair, const PairedMappingResult& result, std::string& out)>;
+    using BlockSink = std::function<void(std::string_view block)>;
+    std::size_t runFormatted(const RecordSource& source, const RecordFormatter& format, const BlockSink& write) const;
+    std::size_t runPairedFormatted(const PairSource& source, const PairFormatter& format, const BlockSink& write) const;
+
+    /**
+     * Variantes par lots d'enregistrements : la source émet des RecordBatch déjà remplis
+     * (FastqFileReader::forEachBatch), passés tels quels aux threads de calcul (la colonne
+     * des séquences est le bloc de ReadMapper::mapBatch) ; après l'écriture, chaque lot est
+     * rendu à pool pour être rempli de nouveau. sink / format reçoivent un lot entier et ses
+     * résultats (results[i] : enregistrement i du lot).
+     */
+    using BatchSource = std::function<void(const std::function<void(std::unique_ptr<RecordBatch>&&)>& emit)>;
+    using BatchSink = std::function<void(const RecordBatch& batch, const std::vector<MappingResult>& results)>;
+    using BatchFormatter = std::function<void(const RecordBatch& batch, const std::vector<MappingResult>& results,
+                                              std::string& out)>;
+    std::size_t runRecordBatches(const BatchSource& source, RecordBatchPool& pool, const BatchSink& sink) const;
+    std::size_t runRecordBatchesFormatted(const BatchSource& source, RecordBatchPool& pool,
+                                          const BatchFormatter& format, const BlockSink& write) const;
+
+    unsigned getNumThreads() const { return numThreads; }
+    std::size_t getBatchSize() const { return batchSize; }
+
+private:
+    const ReadMapper& mapper;
+    unsigned numThreads;
+    std::size_t batchSize;
+    std::size_t maxBatchesInFlight;
+
+    // Lecture, mapping par lots et écriture ordonnée, communs à tous les modes : la source
+    // émet des lots entiers (Records : vecteur de reads ou RecordBatch),
+    // format(records, results, text) dans les threads de calcul après le mapping,
+    // emit(records, results, text) dans l'ordre d'entrée depuis le thread appelant
+    template <typename Records, typename Result, typename Format, typename Emit>
+    std::size_t runBatches(const std::function<void(const std::function<void(Records&&)>&)>& source,
+                           Format&& format, Emit&& emit) const;
+
+    // Regroupe les reads d'une source read par read en lots de batchSize
+    template <typename Record>
+    std::function<void(const std::function<void(std::vector<Record>&&)>&)>
+    groupIntoBatches(const std::function<void(const std::function<void(Record&&)>&)>& source) const;
+};
+
+#endif
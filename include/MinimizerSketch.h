@@ -0,0 +1,92 @@
+#ifndef MINIMIZERSKETCH_H
+#define MINIMIZERSKETCH_H
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include "KmerHashTable.h"
+
+/**
+ * Classe MinimizerSketch
+ *
+ * (w,k)-minimiseurs : dans chaque fenêtre de w k-mers consécutifs, on retient celui
+ * dont le code haché (KmerHashTable::mixCode) est minimal (le plus à gauche en cas
+ * d'égalité). Chaque position retenue n'est émise qu'une fois.
+ *
+ * Deux séquences qui partagent un segment exact d'au moins w + k - 1 bases partagent
+ * au moins un minimiseur, à la même position relative : indexer et interroger
+ * seulement les minimiseurs conserve cette garantie en divisant le nombre de k-mers
+ * par ~(w + 1) / 2. Les k-mers contenant une base non-ACGT sont ignorés et
+ * interrompent la fenêtre.
+ */
+class MinimizerSketch {
+private:
+    std::size_t kmerSize;
+    std::size_t windowSize;
+    std::uint64_t mask;
+
+    struct Candidate {
+        std::uint64_t hash;
+        std::uint64_t code;
+        std::size_t position;
+    };
+
+public:
+    // Lève std::invalid_argument si k n'est pas dans [1, 32] ou si w vaut 0
+    MinimizerSketch(std::size_t k, std::size_t w) : kmerSize(k), windowSize(w) {
+        if (k == 0 || k > KmerHashTable::MAX_KMER_SIZE || w == 0) {
+            throw std::invalid_argument("Paramètres de minimiseurs invalides (1 ≤ k ≤ 32, w ≥ 1)");
+        }
+        mask = k == 32 ? ~std::uint64_t(0) : (std::uint64_t(1) << (2 * k)) - 1;
+    }
+
+    std::size_t getKmerSize() const { return kmerSize; }
+    std::size_t getWindowSize() const { return windowSize; }
+
+    /**
+     * Parcourt les minimiseurs d'une séquence de longueur length.
+     * baseCode(i) renvoie le code 2 bits de la base i, ou une valeur > 3 pour une base non-ACGT ;
+     * callback(position, code) est appelé pour chaque minimiseur, par positions croissantes.
+     * File monotone dans un tampon circulaire de w cases : O(1) amorti par base.
+     */
+    template <typename BaseCode, typename Callback>
+    void forEach(std::size_t length, BaseCode&& baseCode, Callback&& callback) const {
+        std::vector<Candidate> queue(windowSize);
+        std::size_t head = 0, count = 0;
+        std::size_t lastEmitted = SIZE_MAX;
+        std::uint64_t code = 0;
+        std::size_t valid = 0; // bases ACGT consécutives terminant en i
+
+        for (std::size_t i = 0; i < length; ++i) {
+            unsigned base = baseCode(i);
+            if (base > 3) {
+                valid = 0;
+                count = 0;
+                continue;
+            }
+            code = ((code << 2) | base) & mask;
+            if (++valid < kmerSize) continue;
+
+            const std::size_t position = i + 1 - kmerSize;
+            const std::uint64_t hash = KmerHashTable::mixCode(code);
+            // Le candidat le plus ancien sort de la fenêtre [position - w + 1, position]
+            if (count > 0 && queue[head].position + windowSize <= position) {
+                head = (head + 1) % windowSize;
+                --count;
+            }
+            // Les candidats plus grands que le nouveau ne seront jamais minimaux
+            while (count > 0 && queue[(head + count - 1) % windowSize].hash > hash) {
+                --count;
+            }
+            queue[(head + count) % windowSize] = {hash, code, position};
+            ++count;
+
+            if (valid >= kmerSize + windowSize - 1 && queue[head].position != lastEmitted) {
+                lastEmitted = queue[head].position;
+                callback(queue[head].position, queue[head].code);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef MYERSEDITDISTANCE_H
+#define MYERSEDITDISTANCE_H
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "KmerHashTable.h"
+
+/**
+ * Classe MyersEditDistance
+ *
+ * Distance d'édition d'un motif (un read) contre un texte par l'algorithme bit-parallèle
+ * de Myers : une colonne de la matrice de programmation dynamique est codée par ses
+ * différences verticales (+1 / -1) sur des mots de 64 bits, 64 lignes par opération.
+ * Au-delà de 64 bases, le motif est découpé en blocs de 64 lignes enchaînés par la
+ * retenue horizontale (Myers 1999, version par blocs).
+ *
+ * Avec un seuil maxDistance, seuls les blocs dont une cellule peut rester ≤ maxDistance
+ * sont calculés (coupure d'Ukkonen) : le coût ne dépend plus que du seuil et pas de la
+ * longueur du read. Un caractère autre que A, C, G, T ne correspond à rien.
+ */
+class MyersEditDistance {
+public:
+    explicit MyersEditDistance(std::string_view pattern);
+
+    std::size_t length() const { return patternLength; }
+
+    /**
+     * Plus petite distance d'édition entre le motif entier et une sous-chaîne de text
+     * (début et fin libres dans text) ; maxDistance + 1 dès qu'elle dépasse maxDistance (≥ 0).
+     */
+    int search(std::string_view text, int maxDistance) const;
+
+    // Même recherche sur un texte donné par ses codes : codeAt(j) ∈ {0, 1, 2, 3} pour
+    // A, C, G, T, 4 pour une base ambiguë (PackedSequence lue sans copie)
+    template <typename CodeAt>
+    int search(std::size_t textLength, CodeAt&& codeAt, int maxDistance) const;
+
+private:
+    static constexpr unsigned WORD_BITS = 64;
+    static constexpr unsigned ALPHABET = 5; // A, C, G, T, autre
+
+    std::size_t patternLength;
+    std::size_t blockCount;
+    std::vector<std::uint64_t> peq; // peq[b * ALPHABET + c] : lignes du bloc b égales à c
+
+    struct Block {
+        std::uint64_t pv; // différences verticales +1
+        std::uint64_t mv; // différences verticales -1
+        int score;        // cellule de la dernière ligne du bloc
+    };
+
+    // Lignes du bloc b (le dernier bloc peut être incomplet)
+    int rowsIn(std::size_t b) const {
+        return static_cast<int>(std::min<std::size_t>(WORD_BITS, patternLength - b * WORD_BITS));
+    }
+
+    // Avance le bloc d'une colonne ; hin : différence horizontale en entrée (ligne du
+    // dessus), retourne celle de la dernière ligne du bloc
+    static int advance(Block& block, std::uint64_t eq, int hin, unsigned lastRow) {
+        const std::uint64_t hinNegative = hin < 0 ? 1 : 0;
+        const std::uint64_t xv = eq | block.mv;
+        eq |= hinNegative;
+        const std::uint64_t xh = (((eq & block.pv) + block.pv) ^ block.pv) | eq;
+        std::uint64_t ph = block.mv | ~(xh | block.pv);
+        std::uint64_t mh = block.pv & xh;
+        const int hout = static_cast<int>((ph >> lastRow) & 1) - static_cast<int>((mh >> lastRow) & 1);
+        ph <<= 1;
+        mh <<= 1;
+        mh |= hinNegative;
+        ph |= hin > 0 ? 1 : 0;
+        block.pv = mh | ~(xv | ph);
+        block.mv = ph & xv;
+        return hout;
+    }
+};
+
+template <typename CodeAt>
+int MyersEditDistance::search(std::size_t textLength, CodeAt&& codeAt, int maxDistance) const {
+    const int m = static_cast<int>(patternLength);
+    if (m == 0) return 0;
+    // Supprimer tout le motif coûte m : au-delà, le seuil ne coupe plus rien
+    const int k = std::clamp(maxDistance, 0, m);
+
+    thread_local std::vector<Block> blocks;
+    blocks.resize(blockCount);
+    // Colonne 0 : D[i][0] = i ; blocs actifs jusqu'à y, le premier dont le bas dépasse k
+    std::size_t y = std::min(blockCount, static_cast<std::size_t>(k + WORD_BITS - 1) / WORD_BITS);
+    y = y > 0 ? y - 1 : 0;
+    for (std::size_t b = 0, row = 0; b <= y; ++b) {
+        row += static_cast<std::size_t>(rowsIn(b));
+        blocks[b] = {~std::uint64_t(0), 0, static_cast<int>(row)};
+    }
+    const std::size_t last = blockCount - 1;
+    const unsigned lastRow = static_cast<unsigned>(rowsIn(last) - 1);
+    auto lastRowOf = [&](std::size_t b) { return b == last ? lastRow : WORD_BITS - 1; };
+
+    int best = y == last ? m : k + 1;
+    for (std::size_t j = 0; j < textLength && best > 0; ++j) {
+        const unsigned c = codeAt(j);
+        const std::uint64_t* eq = peq.data() + c;
+        int carry = 0; // D[0][j] = 0 : début libre dans le texte
+        for (std::size_t b = 0; b <= y; ++b) {
+            carry = advance(blocks[b], eq[b * ALPHABET], carry, lastRowOf(b));
+            blocks[b].score += carry;
+        }
+        // Le bloc suivant peut descendre sous k : il est (ré)initialisé à partir du bas du
+        // bloc y dans la colonne précédente, toutes ses différences verticales à +1
+        if (y < last && blocks[y].score - carry <= k && ((eq[(y + 1) * ALPHABET] & 1) || carry < 0)) {
+            ++y;
+            blocks[y] = {~std::uint64_t(0), 0, blocks[y - 1].score - carry + rowsIn(y)};
+            carry = advance(blocks[y], eq[y * ALPHABET], carry, lastRowOf(y));
+            blocks[y].score += carry;
+        }
+        if (y == last) best = std::min(best, blocks[last].score);
+        // Blocs dont toutes les cellules dépassent k : abandonnés
+        while (y > 0 && blocks[y].score >= k + rowsIn(y)) --y;
+    }
+    return best <= k ? best : maxDistance + 1;
+}
+
+#endif
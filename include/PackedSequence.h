@@ -0,0 +1,114 @@
+#ifndef PACKEDSEQUENCE_H
+#define PACKEDSEQUENCE_H
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Classe PackedSequence
+ *
+ * Séquence nucléotidique compactée sur 2 bits par base (A=0, C=1, G=2, T=3),
+ * 32 bases par mot de 64 bits. Les positions qui ne sont pas A/C/G/T (N et codes
+ * d'ambiguïté IUPAC) sont décrites par une table annexe d'intervalles [début, fin)
+ * et sont relues comme 'N'. La casse n'est pas conservée (les bases masquées en
+ * minuscules sont relues en majuscules).
+ *
+ * Un filtre d'un bit par bloc de 256 bases évite la recherche dans la table des N
+ * pour les blocs qui n'en contiennent pas : la lecture d'une base reste O(1) en
+ * pratique. Comme IndexArray, les données peuvent appartenir à l'objet ou être
+ * une vue sur un index projeté en mémoire.
+ */
+class PackedSequence {
+public:
+    // Intervalle [start, end) de bases non-ACGT
+    struct NRun {
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    static constexpr std::size_t BASES_PER_WORD = 32;
+    static constexpr std::size_t N_BLOCK_SHIFT = 8; // blocs de 256 bases
+
+private:
+    std::vector<std::uint64_t> wordStorage;
+    std::vector<NRun> runStorage;
+    std::vector<std::uint64_t> nBlocks; // 1 bit par bloc contenant au moins un N
+    const std::uint64_t* words = nullptr;
+    const NRun* nRuns = nullptr;
+    std::size_t runCount = 0;
+    std::size_t baseCount = 0;
+
+    void buildNBlocks();
+    bool lookupN(std::size_t i) const;
+
+public:
+    PackedSequence() = default;
+    explicit PackedSequence(std::string_view sequence);
+
+    // words et nRuns pointent dans les tampons : copie interdite, déplacement autorisé
+    PackedSequence(const PackedSequence&) = delete;
+    PackedSequence& operator=(const PackedSequence&) = delete;
+    PackedSequence(PackedSequence&&) = default;
+    PackedSequence& operator=(PackedSequence&&) = default;
+
+    // Vue sans copie sur les sections d'un index projeté
+    static PackedSequence view(const std::uint64_t* wordData, std::size_t n,
+                               const NRun* runData, std::size_t runN);
+
+    // Code 2 bits de la base i (sans tenir compte des N)
+    unsigned code(std::size_t i) const {
+        return static_cast<unsigned>(words[i / BASES_PER_WORD] >> (2 * (i % BASES_PER_WORD))) & 3u;
+    }
+
+    bool isN(std::size_t i) const {
+        if (runCount == 0) return false;
+        std::size_t block = i >> N_BLOCK_SHIFT;
+        if (!((nBlocks[block >> 6] >> (block & 63)) & 1u)) return false;
+        return lookupN(i);
+    }
+
+    // Base i en majuscule : 'A', 'C', 'G', 'T' ou 'N'
+    char operator[](std::size_t i) const {
+        return isN(i) ? 'N' : "ACGT"[code(i)];
+    }
+
+    // Complément de la base i ('N' reste 'N')
+    char complementAt(std::size_t i) const {
+        return isN(i) ? 'N' : "TGCA"[code(i)];
+    }
+
+    // Vrai si [pos, pos + len) contient au moins une base non-ACGT
+    bool hasNInRange(std::size_t pos, std::size_t len) const;
+
+    // Code des len ≤ 32 bases à partir de pos, première base en poids fort :
+    // l'ordre numérique des codes est l'ordre lexicographique des k-mers
+    std::uint64_t packedCode(std::size_t pos, std::size_t len) const {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < len; ++i) {
+            value = (value << 2) | code(pos + i);
+        }
+        return value;
+    }
+
+    // Copie des bases [pos, pos + len) (tronquée à la fin de la séquence)
+    std::string extract(std::size_t pos, std::size_t len) const;
+
+    std::size_t size() const { return baseCount; }
+    std::size_t length() const { return baseCount; }
+    bool empty() const { return baseCount == 0; }
+
+    const std::uint64_t* wordData() const { return words; }
+    std::size_t wordCount() const { return (baseCount + BASES_PER_WORD - 1) / BASES_PER_WORD; }
+    const NRun* runData() const { return nRuns; }
+    std::size_t runSize() const { return runCount; }
+
+    // Mémoire utilisée par la séquence compactée (octets)
+    std::size_t memoryBytes() const {
+        return wordCount() * sizeof(std::uint64_t) + runCount * sizeof(NRun) +
+               nBlocks.size() * sizeof(std::uint64_t);
+    }
+};
+
+#endif
@@ -2,9 +2,14 @@
 #define READMAPPER_H
 
 #include "KmerIndex.h"
+#include "BandedAligner.h"
+#include "SeedChainer.h"
 #include <vector>
 #include <string>
+#include <optional>
 #include <unordered_map>
+#include <string_view>
+#include <cstdint>
 #include <cstddef> 
 
 enum class Strand {
@@ -19,6 +24,8 @@ enum class Strand {
  * Cette structure inclut des informations telles que la position de référence,
  * le brin (strand), la confiance, la chaîne CIGAR, la distance d'édition, 
  * et si le mappage est unique.
+ * referencePos, cigarString, editDistance et alignmentScore viennent de l'alignement
+ * en bande (BandedAligner) : referencePos est la première base alignée.
  */ 
 
  struct MappingResult {
@@ -27,10 +34,61 @@ enum class Strand {
     double confidence;
     std::string cigarString;
     int editDistance;
+    int alignmentScore;
     bool isUnique;
     std::vector<std::size_t> kmerMatches;
 };  
 
+/**
+ * \struct PairedMappingResult
+ * \brief Résultat du mappage d'une paire de reads (R1, R2)
+ * properPair : mates sur des brins opposés, face à face, à une distance compatible avec la
+ * distribution des tailles d'insert ; insertSize est alors la taille du fragment (0 sinon).
+ * mate1Rescued / mate2Rescued : mate retrouvé par alignement autour de son partenaire.
+ */
+struct PairedMappingResult {
+    MappingResult mate1{};
+    MappingResult mate2{};
+    bool properPair = false;
+    std::size_t insertSize = 0;
+    bool mate1Rescued = false;
+    bool mate2Rescued = false;
+};
+
+/**
+ * \struct InsertSizeDistribution
+ * \brief Tailles de fragment d'une bibliothèque paired-end (moyenne, écart-type) ;
+ * samples : nombre de paires dont elles sont estimées (0 : valeurs a priori).
+ */
+struct InsertSizeDistribution {
+    double mean = 300.0;
+    double stdDev = 50.0;
+    std::size_t samples = 0;
+};
+
+/**
+ * \struct ReadBlock
+ * \brief Bloc de reads contigu (structure de tableaux) : les bases de tous les reads
+ * sont concaténées dans sequences, le read i occupe [offsets[i], offsets[i + 1]).
+ */
+struct ReadBlock {
+    std::string sequences;
+    std::vector<std::size_t> offsets{0};
+
+    void add(std::string_view read) {
+        sequences.append(read);
+        offsets.push_back(sequences.size());
+    }
+    void clear() {
+        sequences.clear();
+        offsets.assign(1, 0);
+    }
+    std::size_t size() const { return offsets.size() - 1; }
+    std::string_view read(std::size_t i) const {
+        return std::string_view(sequences).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    }
+};
+
 /**
  * @class ReadMapper
  * @brief Classe pour mapper des séquences reads sur un génome de référence.
@@ -41,21 +99,128 @@ enum class Strand {
 
 class ReadMapper {
 public:
-    ReadMapper(const std::string& referenceGenome, std::size_t kmerSize = 20, std::size_t stepSize = 3);
+    ReadMapper(const std::string& referenceGenome, std::size_t kmerSize = 20, std::size_t stepSize = 3,
+               const IndexOptions& options = {});
+
+    // Construit le mapper sur un index déjà construit ou chargé depuis le disque (KmerIndex::load)
+    explicit ReadMapper(KmerIndex&& index);
     
     MappingResult mapRead(const std::string& read) const;
+
+    /**
+     * Mappe un bloc de reads ; mêmes résultats que mapRead sur chaque read, dans l'ordre du bloc.
+     * Les graines de tous les reads sont triées par code avant la recherche : les accès à
+     * l'index suivent l'ordre lexicographique et chaque k-mer distinct du bloc n'est
+     * recherché (et localisé) qu'une fois.
+     */
+    std::vector<MappingResult> mapBatch(const ReadBlock& block) const;
+
+    /**
+     * Mappe des paires de reads (orientation FR) : le read i de mates1 est apparié au read i
+     * de mates2. Les graines des deux mates sont cherchées ensemble (comme mapBatch), la
+     * distribution des tailles d'insert est estimée sur les paires non ambiguës du lot
+     * (la distribution a priori sert en dessous de MIN_INSERT_SAMPLES paires), puis les
+     * candidats vérifiés des deux mates sont appariés. Sans paire correcte, le mate manquant
+     * est aligné dans une fenêtre autour de son partenaire (sauvetage).
+     * Lève std::invalid_argument si les deux blocs n'ont pas la même taille.
+     */
+    std::vector<PairedMappingResult> mapPairs(const ReadBlock& mates1, const ReadBlock& mates2) const;
+    PairedMappingResult mapPair(const std::string& read1, const std::string& read2) const;
+
+    // Distribution a priori des tailles d'insert, utilisée quand un lot en donne trop peu
+    void setInsertSizePrior(const InsertSizeDistribution& prior) { insertSizePrior = prior; }
+    const InsertSizeDistribution& getInsertSizePrior() const { return insertSizePrior; }
+
+    // Moyenne et écart-type des tailles de fragment, hors valeurs aberrantes ; prior s'il
+    // y en a moins de MIN_INSERT_SAMPLES
+    static InsertSizeDistribution estimateInsertSize(std::vector<std::size_t> lengths,
+                                                     const InsertSizeDistribution& prior);
+
+    static constexpr std::size_t MIN_INSERT_SAMPLES = 20;
+    // Paire correcte : taille de fragment à moins de PROPER_PAIR_STD_DEVS écarts-types de la moyenne
+    static constexpr double PROPER_PAIR_STD_DEVS = 4.0;
+    // Demi-largeur maximale (bases) de la bande de sauvetage d'un mate, quel que soit l'écart-type
+    static constexpr std::size_t MAX_RESCUE_BAND = 256;
+    // Pénalité d'un placement non apparié des deux mates (BWA-MEM)
+    static constexpr int UNPAIRED_PENALTY = 17;
     
     const KmerIndex& getIndex() const { return kmerIndex; }
+
+    /**
+     * Filtre des candidats : avant évaluation et alignement, la distance d'édition du read
+     * contre la référence autour de chaque candidat est calculée (Myers, bit-parallèle) et
+     * les candidats au-delà de maxDistance sont écartés. NO_EDIT_DISTANCE_LIMIT : pas de filtre.
+     */
+    static constexpr int NO_EDIT_DISTANCE_LIMIT = -1;
+    void setMaxEditDistance(int maxDistance) { maxEditDistance = maxDistance < 0 ? NO_EDIT_DISTANCE_LIMIT : maxDistance; }
+    int getMaxEditDistance() const { return maxEditDistance; }
+
+    /**
+     * Graines répétées : une graine de plus de maxOccurrences occurrences dans l'index est
+     * ignorée (la largeur de son intervalle est connue avant toute localisation) ; les
+     * k-mers masqués de l'index (IndexOptions::maskThreshold) ne sont pas même recherchés.
+     * 0 ou KmerIndex::NO_OCCURRENCE_LIMIT : pas de limite.
+     */
+    void setMaxOccurrences(std::size_t limit) { maxOccurrences = limit == 0 ? KmerIndex::NO_OCCURRENCE_LIMIT : limit; }
+    std::size_t getMaxOccurrences() const { return maxOccurrences; }
+
+    // Nombre de candidats (les mieux classés par les k-mers) alignés base par base
+    static constexpr std::size_t MAX_VERIFIED_CANDIDATES = 4;
     
 private:
     KmerIndex kmerIndex;
     std::size_t kmerSize;
     std::size_t stepSize;
+    BandedAligner aligner;
+    int maxEditDistance = NO_EDIT_DISTANCE_LIMIT;
+    std::size_t maxOccurrences = KmerIndex::NO_OCCURRENCE_LIMIT;
+    InsertSizeDistribution insertSizePrior;
+
+    // Candidat vérifié : alignement en bande autour de la diagonale du candidat
+    struct Hit {
+        BandedAligner::Alignment alignment;
+        std::size_t diagonal;
+        Strand strand;
+    };
+    SeedChainer chainer;
     
-    std::vector<std::pair<std::size_t, Strand>> findCandidatePositions(const std::string& read) const;
-    double evaluatePosition(const std::string& read, std::size_t pos, Strand strand) const;
-    std::string generateCigar(const std::string& read, std::size_t pos, Strand strand) const;
-    int calculateEditDistance(const std::string& s1, const std::string& s2) const;
+    // Ancres de tous les reads d'un bloc (k ≤ 32) : celles du read r sont anchors[begin[r], begin[r + 1])
+    void collectBatchAnchors(const ReadBlock& block, std::vector<Anchor>& anchors,
+                             std::vector<std::size_t>& begin) const;
+    // Graines d'un read (k ≤ 32) : callback(code, i, reverse), i position du k-mer dans le brin interrogé
+    template <typename Callback>
+    void forEachSeed(std::string_view read, Callback&& callback) const;
+    // Une ancre (diagonale, position dans le read, brin) par occurrence de chaque graine du read
+    void collectAnchors(const std::string& read, std::vector<Anchor>& anchors) const;
+    // Candidats (diagonale de début, brin) des chaînes d'ancres, meilleur score de chaîne d'abord ;
+    // trie anchors
+    std::vector<std::pair<std::size_t, Strand>> rankCandidates(std::vector<Anchor>& anchors) const;
+    // Candidats dont la fenêtre de référence est à distance d'édition ≤ maxEditDistance du read
+    // (rc : complément inverse du read, vide s'il n'y a aucun candidat reverse)
+    std::vector<std::pair<std::size_t, Strand>> filterCandidates(std::string_view read, std::string_view rc,
+                                                                std::vector<std::pair<std::size_t, Strand>> candidates) const;
+    // Candidats vérifiés d'un read à partir de ses ancres (classement, filtre, alignement)
+    std::vector<Hit> hitsOf(std::string_view read, std::vector<Anchor>& anchors) const;
+    // Alignement des MAX_VERIFIED_CANDIDATES premiers candidats
+    std::vector<Hit> verifyCandidates(std::string_view read, std::string_view rc,
+                                      const std::vector<std::pair<std::size_t, Strand>>& candidates) const;
+    // Meilleur score d'alignement (premier à égalité) ; unique : un seul placement à ce score
+    static std::size_t bestHitIndex(const std::vector<Hit>& hits, bool& unique);
+    MappingResult resultFromHits(std::string_view read, const std::vector<Hit>& hits) const;
+    MappingResult resultFromHit(std::string_view read, const Hit& hit, bool unique) const;
+
+    // Taille du fragment de deux mates en orientation FR (vide sinon)
+    static std::optional<std::size_t> fragmentLength(const Hit& a, const Hit& b);
+    static bool isProperPair(const Hit& a, const Hit& b, const InsertSizeDistribution& insert);
+    // Alignement du mate dans la fenêtre où la distribution des inserts l'attend
+    std::optional<Hit> rescueMate(std::string_view mate, const Hit& partner,
+                                  const InsertSizeDistribution& insert) const;
+    PairedMappingResult pairMates(std::string_view read1, std::string_view read2,
+                                  const std::vector<Hit>& hits1, const std::vector<Hit>& hits2,
+                                  const InsertSizeDistribution& insert) const;
+    double evaluatePosition(std::string_view read, std::size_t pos, Strand strand) const;
+    // Alignement en bande du brin query du read autour de la diagonale pos (positions absolues)
+    BandedAligner::Alignment alignCandidate(std::string_view query, std::size_t pos) const;
     
     static std::string getReverseComplement(const std::string& seq);
 };
@@ -0,0 +1,89 @@
+#ifndef RECORDBATCH_H
+#define RECORDBATCH_H
+#include "ReadMapper.h"
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+
+/**
+ * Classe RecordBatch
+ *
+ * Lot d'au plus capacity enregistrements FASTQ / FASTA rangés en colonnes (structure de
+ * tableaux) : en-têtes, séquences et qualités ont chacune une zone contiguë d'octets et un
+ * tableau de décalages (ReadBlock). Vider le lot garde la mémoire réservée : un lot réutilisé
+ * (RecordBatchPool) ne fait plus d'allocation une fois sa taille de croisière atteinte, au
+ * lieu de trois std::string par read. La colonne des séquences est directement le bloc
+ * passé à ReadMapper::mapBatch.
+ */
+class RecordBatch {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    explicit RecordBatch(std::size_t capacity = DEFAULT_CAPACITY) : maxRecords(capacity) {
+        headers.offsets.reserve(capacity + 1);
+        sequences.offsets.reserve(capacity + 1);
+        qualities.offsets.reserve(capacity + 1);
+    }
+
+    // Ajoute un enregistrement (qualité vide en FASTA)
+    void add(std::string_view header, std::string_view sequence, std::string_view quality) {
+        headers.add(header);
+        sequences.add(sequence);
+        qualities.add(quality);
+    }
+
+    void clear() {
+        headers.clear();
+        sequences.clear();
+        qualities.clear();
+    }
+
+    std::size_t size() const { return sequences.size(); }
+    std::size_t capacity() const { return maxRecords; }
+    bool isFull() const { return size() >= maxRecords; }
+
+    std::string_view header(std::size_t i) const { return headers.read(i); }
+    std::string_view sequence(std::size_t i) const { return sequences.read(i); }
+    std::string_view quality(std::size_t i) const { return qualities.read(i); }
+
+    const ReadBlock& getSequences() const { return sequences; }
+
+private:
+    std::size_t maxRecords;
+    ReadBlock headers;
+    ReadBlock sequences;
+    ReadBlock qualities;
+};
+
+/**
+ * Classe RecordBatchPool
+ *
+ * Réserve de lots réutilisables, partagée par le lecteur (acquire) et le thread qui a fini
+ * d'utiliser un lot (release) ; protégée par un mutex. Les lots rendus sont vidés mais
+ * gardent leur mémoire : en régime établi, le nombre de lots plafonne au nombre de lots en
+ * circulation (MappingPipeline le borne) et la lecture n'alloue plus.
+ */
+class RecordBatchPool {
+public:
+    explicit RecordBatchPool(std::size_t batchCapacity = RecordBatch::DEFAULT_CAPACITY);
+
+    // Un lot vide : repris dans la réserve, ou alloué si elle est vide
+    std::unique_ptr<RecordBatch> acquire();
+
+    // Rend un lot à la réserve
+    void release(std::unique_ptr<RecordBatch> batch);
+
+    std::size_t getBatchCapacity() const { return batchCapacity; }
+    // Nombre de lots alloués depuis la création de la réserve
+    std::size_t getAllocatedCount() const;
+
+private:
+    std::size_t batchCapacity;
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<RecordBatch>> available;
+    std::size_t allocated = 0;
+};
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef REVERSECOMPLEMENT_H
+#define REVERSECOMPLEMENT_H
+#include <string_view>
+#include <cstddef>
+
+/**
+ * Complément inverse vectorisé des séquences A, C, G, T, N (majuscules ou minuscules,
+ * casse conservée) : écrit seq.size() caractères dans out.
+ * Sur x86-64 avec AVX2 (détecté à l'exécution), 32 bases sont complémentées et inversées
+ * par itération ; sinon, ou pour la fin de la séquence, boucle scalaire.
+ * Retourne false dès qu'un autre caractère est rencontré (codes IUPAC, U, ...) :
+ * le contenu de out n'est alors pas défini et l'appelant applique sa table complète.
+ */
+bool reverseComplementAcgtn(std::string_view seq, char* out);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SAMWRITER_H
+#define SAMWRITER_H
+#include "ReadMapper.h"
+#include "MappingPipeline.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+
+/**
+ * Classe SamWriter
+ *
+ * Sortie des alignements au format SAM (v1.6), lisible par samtools et les autres outils.
+ * Le formatage et l'écriture sont séparés :
+ *  - formatRecord / formatPair ajoutent les lignes d'un read (ou d'une paire) à un tampon
+ *    texte ; les entiers sont convertis par std::to_chars, sans iostreams ni verrou, si bien
+ *    que chaque thread de calcul peut formater son lot dans son propre tampon ;
+ *  - writeBlock écrit un bloc entier (un lot formaté) dans le fichier ; il n'est appelé que
+ *    par un seul thread, celui qui écrit les lots dans l'ordre (MappingPipeline::runFormatted).
+ *
+ * Le brin reverse est écrit comme le veut SAM : séquence complémentée inversée, qualités
+ * inversées, CIGAR dans le sens de la référence. MAPQ vaut 60 pour un placement unique,
+ * 0 sinon. Les tags NM (distance d'édition) et AS (score d'alignement) sont ajoutés.
+ */
+class SamWriter {
+public:
+    struct Reference {
+        std::string name;
+        std::size_t length;
+    };
+
+    static constexpr int UNIQUE_MAPQ = 60;
+
+    // Ouvre filePath en écriture ("-" : sortie standard) ; lève std::runtime_error en cas d'échec
+    explicit SamWriter(const std::string& filePath);
+    ~SamWriter();
+
+    SamWriter(const SamWriter&) = delete;
+    SamWriter& operator=(const SamWriter&) = delete;
+
+    // En-tête : @HD, une ligne @SQ par séquence de référence, @PG
+    void writeHeader(const std::vector<Reference>& references, const std::string& commandLine = "");
+
+    // Écrit un bloc de lignes déjà formatées ; lève std::runtime_error en cas d'erreur d'écriture
+    void writeBlock(std::string_view block);
+
+    // Vide les tampons du fichier ; lève std::runtime_error en cas d'erreur d'écriture
+    void flush();
+
+    // Ajoute à out la ligne SAM d'un read mappé sur la référence referenceName
+    static void formatRecord(std::string& out, const ReadRecord& record, const MappingResult& result,
+                             std::string_view referenceName);
+
+    // Même ligne pour l'enregistrement i d'un lot en colonnes
+    static void formatRecord(std::string& out, const RecordBatch& batch, std::size_t i,
+                             const MappingResult& result, std::string_view referenceName);
+
+    // Ajoute à out les deux lignes SAM d'une paire (drapeaux de paire, mate, taille d'insert)
+    static void formatPair(std::string& out, const ReadPair& pair, const PairedMappingResult& result,
+                           std::string_view referenceName);
+
+    // Nom du read : en-tête sans '@' ou '>' initial, jusqu'au premier blanc
+    static std::string_view readName(std::string_view header);
+
+private:
+    std::FILE* file = nullptr;
+    bool ownsFile = false;
+};
+
+#endif
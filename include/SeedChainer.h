@@ -0,0 +1,58 @@
+#ifndef SEEDCHAINER_H
+#define SEEDCHAINER_H
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Une graine du read retrouvée dans la référence : diagonale = position dans la référence
+// - position dans le brin du read interrogé (readPos)
+struct Anchor {
+    std::uint64_t diagonal;
+    std::uint32_t readPos;
+    std::uint32_t reverse; // 1 : graine du complément inverse du read
+};
+
+// Meilleure chaîne d'un groupe d'ancres voisines
+struct Chain {
+    std::size_t diagonal;      // diagonale de la première ancre (début du read)
+    bool reverse;
+    int score;                 // bases du read couvertes par la chaîne, moins les écarts
+    std::uint32_t anchorCount;
+};
+
+/**
+ * Classe SeedChainer
+ *
+ * Chaînage des graines : les ancres sont triées par (brin, diagonale) par tri radix,
+ * regroupées tant que deux diagonales consécutives sont à moins de bandWidth (un indel
+ * décale la diagonale sans séparer le groupe), puis chaque groupe est chaîné par
+ * programmation dynamique colinéaire (comme minimap2) :
+ *   f(j) = max(k, max_i f(i) + min(Δread, Δréf, k) - |Δréf - Δread|)
+ * sur les maxPredecessors ancres précédentes, Δread > 0 et Δréf > 0.
+ */
+class SeedChainer {
+public:
+    static constexpr std::size_t DEFAULT_BAND_WIDTH = 15;
+    static constexpr std::size_t DEFAULT_MAX_PREDECESSORS = 50;
+
+    explicit SeedChainer(std::size_t kmerSize, std::size_t bandWidth = DEFAULT_BAND_WIDTH,
+                         std::size_t maxPredecessors = DEFAULT_MAX_PREDECESSORS);
+
+    // Une chaîne par groupe, par score décroissant puis (brin, diagonale) croissants ;
+    // anchors est trié en place
+    std::vector<Chain> chain(std::vector<Anchor>& anchors) const;
+
+    // Tri radix (octet par octet, les octets communs à toutes les clés sont sautés)
+    // par brin puis diagonale ; stable
+    static void sortByDiagonal(std::vector<Anchor>& anchors);
+
+private:
+    std::size_t kmerSize;
+    std::size_t bandWidth;
+    std::size_t maxPredecessors;
+
+    // Meilleure chaîne des ancres [first, last) d'un groupe
+    Chain chainCluster(Anchor* first, Anchor* last) const;
+};
+
+#endif
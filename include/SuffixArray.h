@@ -2,7 +2,13 @@
 #define SUFFIXARRAY_H
 #include <string>  // Pour utiliser std::string (manipulation des chaînes de caractères)
 #include <vector>
+#include <string_view>
+#include <memory>
+#include <utility>
 #include <stdexcept>  // Pour utiliser std::invalid_argument (gestion des erreurs)
+#include "IndexFile.h"
+#include "IndexArray.h"
+#include "PackedSequence.h"
 
 // doxygen documentation
 /**
@@ -12,24 +18,67 @@
  * Elle permet également de rechercher un facteur dans la chaîne de caractères.
  */
 class SuffixArray{
+    public:
+    /**
+     * Méthode de construction de la table des suffixes.
+     * SAIS : tri par induction (SA-IS), temps linéaire, méthode par défaut.
+     * NAIVE_SORT : ancien tri par comparaison (std::sort + compareSuffixes),
+     * O(n² log n) dans le pire cas, conservé pour valider les résultats dans les tests.
+     * PARALLEL_DOUBLING : doublement de préfixe (Manber-Myers) avec tri radix
+     * parallèle OpenMP, O(n log n) réparti sur numThreads threads. Gourmand en mémoire :
+     * deux tableaux d'entrées (clé 64 bits + indice 32 bits, 16 octets avec l'alignement)
+     * et deux tableaux de rangs 32 bits, soit ~40 octets par base pendant la construction
+     * (~4 fois SA-IS) : à choisir explicitement, pas d'après le nombre de threads.
+     */
+    enum class BuildMethod { SAIS, NAIVE_SORT, PARALLEL_DOUBLING };
+
     private:
-   // std::string text;  //ma chaine de caractere
-    std::string text;  //mon motif 
-    std::vector<size_t> suffixArray;   // ma table SA
-    std::vector<size_t> lcpArray;     // ma table lcp
+    // Projection du fichier d'index (tables chargées depuis le disque)
+    std::shared_ptr<const MappedFile> mapping;
+
+    // Tables utilisées par la recherche : stockage propre ou vues sur la projection
+    PackedSequence sequence;     // texte compacté sur 2 bits, partagé avec KmerIndex et ReadMapper
+    size_t textLength = 0;       // longueur du texte, sentinelle '$' virtuelle comprise
+    IndexArray suffixArray;      // ma table SA (4, 5 ou 8 octets par entrée)
+    CompactLcpArray lcpArray;    // ma table lcp (1 octet par entrée + débordements)
+    unsigned indexWidth = 8;     // largeur des entrées de la table SA
+    IndexArray prefixTable;      // table des q-grammes : début de l'intervalle SA de chaque q-mer
+    unsigned prefixLength = 0;   // q (0 : pas de table)
+    int numThreads = 1;               // nombre de threads OpenMP pour la construction
+
+    // constructeur utilisé par load()
+    SuffixArray() = default;
 
     //contruire SA
-    void buildSuffixArray();
+    void buildSuffixArray(BuildMethod method);
+
+    // construction par tri par comparaison (ancienne méthode)
+    void buildSuffixArrayNaive();
+
+    // construction par induction SA-IS
+    void buildSuffixArraySais();
+
+    // construction parallèle par doublement de préfixe
+    void buildSuffixArrayParallel();
 
     //contruire lcp
     void buildLcpArray();
 
+    // algorithme de Kasai avec un rang inverse de type Rank (32 ou 64 bits)
+    template <typename Rank>
+    void buildLcpArrayWithRank();
+
     // Fonctions pour la recherche d'occurrences
-    //documentation de ces deux fonction:
-    //lowerBound: retourne la position du premier suffixe dans la table des suffixes qui est supérieur ou égal à un motif donné.
-    //upperBound: retourne la position du premier suffixe dans la table des suffixes qui est strictement supérieur à un motif donné.
-    size_t lowerBound(const std::string& text) const;
-    size_t upperBound(const std::string& text) const;
+    //equalRange: retourne [lower, upper), où lower est la position du premier suffixe supérieur ou égal
+    //au motif et upper celle du premier suffixe strictement supérieur (motif non préfixe).
+    //Les deux bornes sont obtenues en une seule descente, accélérée par l'heuristique mlr.
+    std::pair<size_t, size_t> equalRange(std::string_view motif) const;
+
+    // compare à partir du rang matched (déjà égal) ; matched reçoit la longueur du préfixe commun
+    int compareSuffixFrom(size_t pos, std::string_view motif, size_t& matched) const;
+
+    // compare le suffixe commençant en pos au motif : <0, 0 (le motif en est un préfixe) ou >0
+    int compareSuffix(size_t pos, std::string_view motif) const;
 
 
     public:
@@ -39,14 +88,56 @@ class SuffixArray{
     // c'est une bonne pratique de l'utiliser pour eviter des erreurs de compilation
     //explicit SuffixArray(const std::string& inputtext, bool buildSA = true);
      // Constructeur
-    explicit SuffixArray(const std::string& inputtext);
+    // numThreads = 0 : utiliser tous les threads disponibles (omp_get_max_threads)
+    // indexWidth = 0 : largeur des entrées SA choisie d'après la longueur du texte (4, 5 ou 8 octets) ;
+    // une largeur imposée hors de {4, 5, 8} ou trop petite pour le texte lève std::invalid_argument
+    explicit SuffixArray(const std::string& inputtext, BuildMethod method = BuildMethod::SAIS,
+                         int numThreads = 0, unsigned indexWidth = 0);
+
+
+    // Les vues internes pointent dans les tampons : copie interdite, déplacement autorisé
+    SuffixArray(const SuffixArray&) = delete;
+    SuffixArray& operator=(const SuffixArray&) = delete;
+    SuffixArray(SuffixArray&&) = default;
+    SuffixArray& operator=(SuffixArray&&) = default;
 
+    /**
+     * Construit la table des q-grammes (4^q + 1 entrées) : pour chaque q-mer ACGT de code c,
+     * l'intervalle SA des suffixes qui commencent par ce q-mer est inclus dans
+     * [table[c], table[c + 1]). La recherche d'un motif de longueur ≥ q démarre
+     * dans cet intervalle au lieu de [0, n). q = 0 supprime la table.
+     */
+    void buildPrefixTable(unsigned q);
+
+    // q par défaut : le plus grand q ≤ 12 tel que 4^q ≤ n / 4 (au moins 4 suffixes par case en moyenne)
+    static unsigned defaultPrefixLength(size_t textLength);
+
+    unsigned getPrefixLength() const { return prefixLength; }
+
+    // Ajoute les sections PACKED_TEXT, N_RUNS, SUFFIX_ARRAY, LCP et PREFIX_TABLE à un index en cours d'écriture
+    void save(IndexFile::Writer& writer) const;
+
+    // Recharge les tables depuis un index projeté en mémoire (sans copie)
+    static SuffixArray load(const IndexFile::Reader& reader);
 
     //getter de SA
-    const std::vector<size_t>& getSuffixArray() const;
+    const IndexArray& getSuffixArray() const;
 
     //getter de lcp
-    const std::vector<size_t>& getLcpArray() const;
+    const CompactLcpArray& getLcpArray() const;
+
+    // largeur en octets des entrées de la table SA
+    unsigned getIndexWidth() const { return indexWidth; }
+
+    // séquence indexée (sans la sentinelle)
+    const PackedSequence& getSequence() const { return sequence; }
+
+    // Cède la séquence compactée (construction d'un FMIndex) : la table ne doit plus
+    // être interrogée ensuite. Réservé aux tables construites en mémoire.
+    PackedSequence releaseSequence() { return std::move(sequence); }
+
+    // caractère i du texte : base de la séquence, ou '$' pour la sentinelle finale
+    char charAt(size_t i) const { return i < sequence.length() ? sequence[i] : '$'; }
 
 
     //rechrache d'un facteur dans ma table SA (avce une methode déchotomique) 
@@ -60,7 +151,14 @@ class SuffixArray{
 
      std::vector<size_t> findOccurrences(const std::string& motif) const;
 
-     size_t getReferenceLength() const { return text.length(); }
+     // Intervalle [lower, upper) de la table SA des suffixes préfixés par le motif,
+     // sans allocation (vide si le motif est vide ou plus long que le texte)
+     std::pair<size_t, size_t> findInterval(std::string_view motif) const;
+
+     // Position dans le texte du suffixe de rang r (r dans un intervalle de findInterval)
+     size_t positionAt(size_t r) const { return suffixArray[r]; }
+
+     size_t getReferenceLength() const { return textLength; }
 
 };
 
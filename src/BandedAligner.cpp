@@ -0,0 +1,418 @@
+#include "BandedAligner.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ALIGNER_X86 1
+#endif
+
+namespace {
+
+constexpr std::int16_t NEG = -30000;  // cellule hors bande
+constexpr std::size_t LANES = 16;     // cellules par vecteur AVX2
+constexpr long MAX_SCORE = 30000;
+
+// Octet de trace par cellule : origine de H sur 2 bits, puis extension de E et de F
+enum : std::uint8_t {
+    FROM_DIAGONAL = 0, FROM_E = 1, FROM_F = 2, FRESH_START = 3,
+    E_EXTENDED = 4, F_EXTENDED = 8
+};
+
+// Codes des bases : 0-3 pour ACGT ; 4 dans le read et 5 dans la cible pour le reste,
+// pour que deux N ne soient jamais égaux
+std::int16_t baseCode(char c, std::int16_t other) {
+    switch (c) {
+        case 'A': case 'a': return 0;
+        case 'C': case 'c': return 1;
+        case 'G': case 'g': return 2;
+        case 'T': case 't': return 3;
+        default: return other;
+    }
+}
+
+// Tampons réutilisés d'un alignement à l'autre (un jeu par thread).
+// Une anti-diagonale t = i + j est rangée par créneau s : le créneau s contient la
+// diagonale k = j - i - low = 2s + p (p parité de t - low), soit la cellule i = iTop - s.
+// Les dépendances restent au même créneau (t - 2) ou au créneau voisin (t - 1) : les
+// vecteurs sont relus à l'adresse exacte où ils ont été écrits et décalés en registre.
+struct Workspace {
+    // H sur t, t - 1, t - 2 ; E et F sur t, t - 1
+    std::array<std::vector<std::int16_t>, 3> h;
+    std::array<std::vector<std::int16_t>, 2> e, f;
+    // Indexés par créneau depuis qBase = pad + m - iTop : read à l'envers, read[iTop - 1 - s]
+    std::vector<std::int16_t> query;
+    std::vector<std::int16_t> startScore;  // commencer après iTop - 1 - s bases du read
+    std::vector<std::int16_t> endAdjust;   // finir après iTop - s bases du read
+    std::vector<std::int16_t> target;      // cible j en pad + j - 1
+    std::vector<std::uint8_t> trace;       // slotsPadded octets par anti-diagonale
+};
+
+thread_local Workspace workspace;
+
+// Meilleure cellule ; à score égal, la plus proche de la diagonale attendue (dans une
+// répétition en tandem, chaque candidat garde ainsi son propre placement), puis la
+// première anti-diagonale et le plus petit i
+struct Best {
+    int score = -MAX_SCORE;
+    long i = 0, j = 0;
+    long diagonal = 0;
+
+    long offset(long ci, long cj) const { return std::labs(cj - ci - diagonal); }
+    void update(int candidate, long ci, long cj) {
+        if (candidate < score) return;
+        if (candidate == score) {
+            const long current = offset(i, j), other = offset(ci, cj);
+            if (other > current || (other == current && (ci + cj != i + j || ci > i))) return;
+        }
+        score = candidate;
+        i = ci;
+        j = cj;
+    }
+};
+
+// Une anti-diagonale : tampons t - 2, t - 1, t et position dans les tableaux d'entrée
+struct Diagonals {
+    const std::int16_t* h2;
+    const std::int16_t* h1;
+    const std::int16_t* e1;
+    const std::int16_t* f1;
+    std::int16_t* h0;
+    std::int16_t* e0;
+    std::int16_t* f0;
+    std::uint8_t* trace;
+    std::size_t qBase;   // créneau 0 dans query, startScore et endAdjust
+    std::size_t tBase;   // créneau 0 dans target
+    long t, iTop, parity;
+    long sLo, sHi;       // créneaux dans la matrice (vide si sLo > sHi)
+};
+
+struct Params {
+    int match, mismatch, gapOpenExtend, gapExtend;
+    long m, n, low, bandWidth;
+    long tMin, tMax;     // anti-diagonales qui coupent la bande
+    long slots;          // créneaux utiles : bandWidth + 1
+    long slotsPadded;    // arrondi à LANES
+    std::size_t pad;     // marge des tableaux d'entrée
+};
+
+// Tampons et bornes de l'anti-diagonale t
+__attribute__((always_inline)) inline Diagonals diagonalAt(Workspace& ws, const Params& p, long t) {
+    const long parity = (t - p.low) & 1;
+    const long iTop = (t - p.low - parity) / 2;
+    const std::size_t h0 = t % 3, h1 = (t + 2) % 3, h2 = (t + 1) % 3;
+    const std::size_t ef0 = t % 2, ef1 = (t + 1) % 2;
+    const long pad = static_cast<long>(p.pad);
+    return Diagonals{ws.h[h2].data(), ws.h[h1].data(), ws.e[ef1].data(), ws.f[ef1].data(),
+                     ws.h[h0].data(), ws.e[ef0].data(), ws.f[ef0].data(),
+                     ws.trace.data() + static_cast<std::size_t>((t - p.tMin) * p.slotsPadded),
+                     static_cast<std::size_t>(pad + p.m - iTop),
+                     static_cast<std::size_t>(pad + t - iTop - 1),
+                     t, iTop, parity,
+                     // 1 ≤ i ≤ m, 1 ≤ j ≤ n, 0 ≤ k ≤ 2w
+                     std::max({0L, iTop - p.m, iTop + 1 - t}),
+                     std::min({p.bandWidth - parity, iTop - 1, p.n - t + iTop})};
+}
+
+void computeScalar(Workspace& ws, const Params& p, Best& best) {
+    for (long t = p.tMin; t <= p.tMax; ++t) {
+        const Diagonals d = diagonalAt(ws, p, t);
+        for (long s = 0; s < p.slots; ++s) {
+            if (s < d.sLo || s > d.sHi) {
+                d.h0[s] = d.e0[s] = d.f0[s] = NEG;
+                continue;
+            }
+            const int diagonal = d.h2[s];
+            const int start = ws.startScore[d.qBase + s];
+            const bool fresh = start > diagonal;
+            const std::int16_t q = ws.query[d.qBase + s];
+            const std::int16_t r = ws.target[d.tBase + s];
+            const int sc = (q > 3 || r > 3) ? -1 : (q == r ? p.match : -p.mismatch);
+            const int hd = std::max(diagonal, start) + sc;
+
+            // E vient de (i, j - 1), diagonale k - 1 ; F de (i - 1, j), diagonale k + 1
+            const long se = s + d.parity - 1, sf = s + d.parity;
+            const int hE = se >= 0 ? d.h1[se] : NEG, eE = se >= 0 ? d.e1[se] : NEG;
+            const int hF = sf < p.slots ? d.h1[sf] : NEG, fF = sf < p.slots ? d.f1[sf] : NEG;
+            const int eOpen = hE - p.gapOpenExtend, eExtend = eE - p.gapExtend;
+            const int fOpen = hF - p.gapOpenExtend, fExtend = fF - p.gapExtend;
+            const int e = std::max({eOpen, eExtend, int(NEG)});
+            const int f = std::max({fOpen, fExtend, int(NEG)});
+            const int h = std::max({hd, e, f});
+
+            std::uint8_t dir = h == hd ? (fresh ? FRESH_START : FROM_DIAGONAL) : (h == e ? FROM_E : FROM_F);
+            if (eExtend > eOpen) dir |= E_EXTENDED;
+            if (fExtend > fOpen) dir |= F_EXTENDED;
+            d.h0[s] = static_cast<std::int16_t>(h);
+            d.e0[s] = static_cast<std::int16_t>(e);
+            d.f0[s] = static_cast<std::int16_t>(f);
+            d.trace[s] = dir;
+
+            const long i = d.iTop - s;
+            best.update(h + ws.endAdjust[d.qBase + s], i, d.t - i);
+    }
+    }
+}
+
+#ifdef ALIGNER_X86
+__attribute__((target("avx2")))
+inline __m256i load(const std::int16_t* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+// Voie s ← voie s - 1 (la voie 0 reçoit la dernière de previous)
+__attribute__((target("avx2")))
+inline __m256i shiftUp(__m256i current, __m256i previous) {
+    return _mm256_alignr_epi8(current, _mm256_permute2x128_si256(previous, current, 0x21), 14);
+}
+
+// Voie s ← voie s + 1 (la dernière voie reçoit la voie 0 de next)
+__attribute__((target("avx2")))
+inline __m256i shiftDown(__m256i current, __m256i next) {
+    return _mm256_alignr_epi8(_mm256_permute2x128_si256(current, next, 0x21), current, 2);
+}
+
+__attribute__((target("avx2")))
+inline int horizontalMax(__m256i v) {
+    __m128i m = _mm_max_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_max_epi16(m, _mm_shuffle_epi32(m, 0x4E));
+    m = _mm_max_epi16(m, _mm_shuffle_epi32(m, 0xB1));
+    m = _mm_max_epi16(m, _mm_shufflelo_epi16(m, 0xB1));
+    return static_cast<std::int16_t>(_mm_cvtsi128_si32(m));
+}
+
+// Mêmes calculs que computeScalar, 16 créneaux à la fois ; les créneaux hors de
+// [sLo, sHi] reçoivent NEG
+__attribute__((target("avx2")))
+void computeAvx2(Workspace& ws, const Params& p, Best& best) {
+    const __m256i neg = _mm256_set1_epi16(NEG);
+    const __m256i three = _mm256_set1_epi16(3);
+    const __m256i match = _mm256_set1_epi16(static_cast<std::int16_t>(p.match));
+    const __m256i mismatch = _mm256_set1_epi16(static_cast<std::int16_t>(-p.mismatch));
+    const __m256i ambiguous = _mm256_set1_epi16(-1);
+    const __m256i openExtend = _mm256_set1_epi16(static_cast<std::int16_t>(p.gapOpenExtend));
+    const __m256i extend = _mm256_set1_epi16(static_cast<std::int16_t>(p.gapExtend));
+    const __m256i laneIndex = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    for (long t = p.tMin; t <= p.tMax; ++t) {
+        const Diagonals d = diagonalAt(ws, p, t);
+        const __m256i below = _mm256_set1_epi16(static_cast<std::int16_t>(d.sLo - 1));
+        const __m256i above = _mm256_set1_epi16(static_cast<std::int16_t>(d.sHi + 1));
+        for (long s = 0; s < p.slotsPadded; s += LANES) {
+            const __m256i slot = _mm256_add_epi16(laneIndex, _mm256_set1_epi16(static_cast<std::int16_t>(s)));
+            const __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi16(slot, below), _mm256_cmpgt_epi16(above, slot));
+
+            const __m256i diagonal = load(d.h2 + s);
+            const __m256i start = load(ws.startScore.data() + d.qBase + s);
+            const __m256i fresh = _mm256_cmpgt_epi16(start, diagonal);
+            const __m256i q = load(ws.query.data() + d.qBase + s);
+            const __m256i r = load(ws.target.data() + d.tBase + s);
+            __m256i sc = _mm256_blendv_epi8(mismatch, match, _mm256_cmpeq_epi16(q, r));
+            sc = _mm256_blendv_epi8(sc, ambiguous, _mm256_or_si256(_mm256_cmpgt_epi16(q, three), _mm256_cmpgt_epi16(r, three)));
+            const __m256i hd = _mm256_adds_epi16(_mm256_max_epi16(diagonal, start), sc);
+
+            const __m256i h1 = load(d.h1 + s);
+            __m256i hE, eE, hF, fF;
+            if (d.parity == 0) {
+                const bool first = s == 0;
+                hE = shiftUp(h1, first ? neg : load(d.h1 + s - LANES));
+                eE = shiftUp(load(d.e1 + s), first ? neg : load(d.e1 + s - LANES));
+                hF = h1;
+                fF = load(d.f1 + s);
+            } else {
+                const bool last = s + static_cast<long>(LANES) >= p.slotsPadded;
+                hE = h1;
+                eE = load(d.e1 + s);
+                hF = shiftDown(h1, last ? neg : load(d.h1 + s + LANES));
+                fF = shiftDown(load(d.f1 + s), last ? neg : load(d.f1 + s + LANES));
+            }
+            const __m256i eOpen = _mm256_subs_epi16(hE, openExtend);
+            const __m256i eExtend = _mm256_subs_epi16(eE, extend);
+            const __m256i fOpen = _mm256_subs_epi16(hF, openExtend);
+            const __m256i fExtend = _mm256_subs_epi16(fF, extend);
+            const __m256i e = _mm256_max_epi16(_mm256_max_epi16(eOpen, eExtend), neg);
+            const __m256i f = _mm256_max_epi16(_mm256_max_epi16(fOpen, fExtend), neg);
+            const __m256i h = _mm256_max_epi16(hd, _mm256_max_epi16(e, f));
+
+            const __m256i fromDiagonal = _mm256_cmpeq_epi16(h, hd);
+            const __m256i fromE = _mm256_cmpeq_epi16(h, e);
+            __m256i dir = _mm256_andnot_si256(fromDiagonal,
+                _mm256_blendv_epi8(_mm256_set1_epi16(FROM_F), _mm256_set1_epi16(FROM_E), fromE));
+            dir = _mm256_or_si256(dir, _mm256_and_si256(_mm256_and_si256(fromDiagonal, fresh), _mm256_set1_epi16(FRESH_START)));
+            dir = _mm256_or_si256(dir, _mm256_and_si256(_mm256_cmpgt_epi16(eExtend, eOpen), _mm256_set1_epi16(E_EXTENDED)));
+            dir = _mm256_or_si256(dir, _mm256_and_si256(_mm256_cmpgt_epi16(fExtend, fOpen), _mm256_set1_epi16(F_EXTENDED)));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d.h0 + s), _mm256_blendv_epi8(neg, h, valid));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d.e0 + s), _mm256_blendv_epi8(neg, e, valid));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d.f0 + s), _mm256_blendv_epi8(neg, f, valid));
+            // 16 mots → 16 octets : packus entrelace les deux moitiés, permute les remet dans l'ordre
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(dir, _mm256_setzero_si256()), 0xD8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d.trace + s), _mm256_castsi256_si128(packed));
+
+            // Meilleure cellule : seules les voies qui portent le maximum du vecteur sont
+            // examinées, et seulement s'il atteint le record
+            const __m256i adjusted = _mm256_blendv_epi8(neg, _mm256_adds_epi16(h, load(ws.endAdjust.data() + d.qBase + s)), valid);
+            const int top = horizontalMax(adjusted);
+            if (top >= best.score) {
+                unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi16(adjusted, _mm256_set1_epi16(static_cast<std::int16_t>(top)))));
+                for (; mask != 0; mask &= mask - 1) {
+                    const long i = d.iTop - s - __builtin_ctz(mask) / 2;
+                    mask &= mask - 1; // deux bits par voie de 16 bits
+                    best.update(top, i, d.t - i);
+                }
+            }
+    }
+    }
+}
+#endif
+
+} // namespace
+
+BandedAligner::BandedAligner() : BandedAligner(Scoring()) {}
+
+BandedAligner::BandedAligner(const Scoring& scoring, std::size_t bandWidth)
+    : scoring(scoring), bandWidth(bandWidth) {
+    if (scoring.match <= 0 || scoring.mismatch < 0 || scoring.gapOpen < 0 ||
+        scoring.gapExtend < 0 || scoring.clipPenalty < 0) {
+        throw std::invalid_argument("Scores d'alignement invalides");
+    }
+}
+
+bool BandedAligner::canAlign(std::size_t queryLength) const {
+    return queryLength <= static_cast<std::size_t>(MAX_SCORE / 2 / scoring.match);
+}
+
+BandedAligner::Alignment BandedAligner::align(std::string_view query, std::string_view target, long diagonal) const {
+    Alignment result;
+    const long m = static_cast<long>(query.length());
+    const long n = static_cast<long>(target.length());
+    if (m == 0 || n == 0) return result;
+    if (!canAlign(query.length())) {
+        throw std::invalid_argument("Read trop long pour l'alignement en bande");
+    }
+    const long low = diagonal - static_cast<long>(bandWidth);
+    const long high = diagonal + static_cast<long>(bandWidth);
+
+    // Read identique à la cible sur la diagonale attendue : score maximal m * match,
+    // atteint seulement sans écart ni écrêtage, et à l'écart 0 de la diagonale
+    if (diagonal >= 0 && diagonal + m <= n) {
+        long i = 0;
+        while (i < m && baseCode(query[i], 4) == baseCode(target[diagonal + i], 5)) ++i;
+        if (i == m) {
+            result.score = static_cast<int>(m) * scoring.match;
+            result.queryEnd = static_cast<std::size_t>(m);
+            result.targetStart = static_cast<std::size_t>(diagonal);
+            result.targetEnd = static_cast<std::size_t>(diagonal + m);
+            result.cigar = std::to_string(m) + 'M';
+            return result;
+        }
+    }
+
+    // Anti-diagonales qui coupent la bande : t = 2i + d = 2j - d avec i, j ≥ 1
+    const long tMin = std::max({2L, 2 + low, 2 - high});
+    const long tMax = std::min({m + n, 2 * m + high, 2 * n - low});
+    if (tMin > tMax) return result; // bande hors de la matrice
+
+    const long slotsPaddedL = static_cast<long>((bandWidth + LANES) / LANES * LANES);
+    const Params params{scoring.match, scoring.mismatch, scoring.gapOpen + scoring.gapExtend,
+                        scoring.gapExtend, m, n, low, static_cast<long>(bandWidth), tMin, tMax,
+                        static_cast<long>(bandWidth) + 1, slotsPaddedL,
+                        static_cast<std::size_t>(slotsPaddedL) + LANES};
+    const std::size_t slotsPadded = static_cast<std::size_t>(params.slotsPadded);
+
+    // Préparation des tampons ; les marges couvrent les créneaux hors de la matrice
+    Workspace& ws = workspace;
+    const std::size_t pad = params.pad;
+    for (auto& buffer : ws.h) buffer.assign(slotsPadded, NEG);
+    for (auto& buffer : ws.e) buffer.assign(slotsPadded, NEG);
+    for (auto& buffer : ws.f) buffer.assign(slotsPadded, NEG);
+    ws.query.assign(static_cast<std::size_t>(m) + 2 * pad, 4);
+    ws.startScore.assign(ws.query.size(), static_cast<std::int16_t>(-scoring.clipPenalty));
+    ws.endAdjust.assign(ws.query.size(), static_cast<std::int16_t>(-scoring.clipPenalty));
+    for (long u = 0; u < m; ++u) ws.query[pad + u] = baseCode(query[m - 1 - u], 4);
+    ws.startScore[pad + m - 1] = 0;
+    ws.endAdjust[pad] = 0;
+    ws.target.assign(static_cast<std::size_t>(n) + 2 * pad, 5);
+    for (long j = 1; j <= n; ++j) ws.target[pad + j - 1] = baseCode(target[j - 1], 5);
+    ws.trace.resize(static_cast<std::size_t>(tMax - tMin + 1) * slotsPadded);
+
+#ifdef ALIGNER_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    const bool useAvx2 = vectorized && hasAvx2;
+#endif
+
+    Best best;
+    best.diagonal = diagonal;
+#ifdef ALIGNER_X86
+    if (useAvx2) {
+        computeAvx2(ws, params, best);
+    } else
+#endif
+    {
+        computeScalar(ws, params, best);
+    }
+    if (best.i == 0) return result;
+
+    // Trace arrière depuis la meilleure cellule
+    auto traceAt = [&](long i, long j) {
+        const long slot = (j - i - low) / 2;
+        return ws.trace[static_cast<std::size_t>(i + j - tMin) * slotsPadded + static_cast<std::size_t>(slot)];
+    };
+    std::string ops; // opérations à l'envers
+    long i = best.i, j = best.j;
+    enum { STATE_H, STATE_E, STATE_F } state = STATE_H;
+    for (;;) {
+        const std::uint8_t dir = traceAt(i, j);
+        if (state == STATE_H) {
+            const std::uint8_t source = dir & 3;
+            if (source == FROM_DIAGONAL || source == FRESH_START) {
+                const std::int16_t q = ws.query[pad + m - i], r = ws.target[pad + j - 1];
+                if (q != r) ++result.editDistance;
+                ops += 'M';
+                --i;
+                --j;
+                if (source == FRESH_START) break;
+            } else {
+                state = source == FROM_E ? STATE_E : STATE_F;
+            }
+        } else if (state == STATE_E) {
+            ops += 'D';
+            ++result.editDistance;
+            --j;
+            if (!(dir & E_EXTENDED)) state = STATE_H;
+        } else {
+            ops += 'I';
+            ++result.editDistance;
+            --i;
+            if (!(dir & F_EXTENDED)) state = STATE_H;
+        }
+    }
+
+    result.score = best.score;
+    result.queryStart = static_cast<std::size_t>(i);
+    result.queryEnd = static_cast<std::size_t>(best.i);
+    result.targetStart = static_cast<std::size_t>(j);
+    result.targetEnd = static_cast<std::size_t>(best.j);
+
+    // CIGAR : écrêtage, opérations regroupées, écrêtage
+    auto append = [&result](std::size_t count, char op) {
+        if (count > 0) result.cigar += std::to_string(count) + op;
+    };
+    append(result.queryStart, 'S');
+    for (std::size_t k = ops.size(); k > 0;) {
+        const char op = ops[k - 1];
+        std::size_t run = 0;
+        while (k > 0 && ops[k - 1] == op) {
+            --k;
+            ++run;
+        }
+        append(run, op);
+    }
+    append(static_cast<std::size_t>(m) - result.queryEnd, 'S');
+    return result;
+}
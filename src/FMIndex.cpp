@@ -0,0 +1,293 @@
+#include "FMIndex.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+// Un bit (de poids faible) par symbole de word égal au symbole répété dans pattern
+inline std::uint64_t matchingSymbols(std::uint64_t word, std::uint64_t pattern) {
+    std::uint64_t x = word ^ pattern;
+    return ~(x | (x >> 1)) & LOW_BITS;
+}
+
+} // namespace
+
+void FMIndex::publish() {
+    blocks = blockStorage.data();
+    blockCount = blockStorage.size();
+    superBlocks = superStorage.data();
+    exceptions = exceptionStorage.data();
+    exceptionCount = exceptionStorage.size();
+    sampleBits = sampleBitStorage.data();
+    sampleBlockCount = sampleBitStorage.size();
+}
+
+FMIndex FMIndex::fromSuffixArray(SuffixArray&& suffixArray, unsigned sampleRate) {
+    if (sampleRate == 0) {
+        throw std::invalid_argument("Taux d'échantillonnage de l'index FM invalide");
+    }
+
+    FMIndex index;
+    const IndexArray& sa = suffixArray.getSuffixArray();
+    const PackedSequence& text = suffixArray.getSequence();
+    const std::size_t n = sa.size();
+
+    index.header.textLength = n;
+    index.header.sampleRate = sampleRate;
+    // Un bloc de plus pour que occ(c, n) lise toujours un bloc existant
+    index.blockStorage.assign(n / BASES_PER_BLOCK + 1, OccBlock{});
+    index.superStorage.assign((index.blockStorage.size() >> SUPERBLOCK_SHIFT) + 1, SuperBlock{});
+    index.sampleBitStorage.assign(n / SAMPLE_BITS_PER_BLOCK + 1, SampleBlock{});
+    // Positions 0, s, 2s, ... < n : leurs valeurs divisées par s tiennent dans widthFor(n / s)
+    const std::size_t sampleCount = (n - 1) / sampleRate + 1;
+    index.samples.assign(sampleCount, IndexArray::widthFor((n - 1) / sampleRate));
+
+    // Un seul balayage de la table SA dans l'ordre des rangs : BWT[r] = T[SA[r] - 1]
+    std::uint64_t counts[6] = {0, 0, 0, 0, 0, 0};
+    std::size_t sampled = 0;
+    for (std::size_t r = 0; r <= n; ++r) {
+        if (r % BASES_PER_BLOCK == 0) {
+            std::size_t b = r / BASES_PER_BLOCK;
+            SuperBlock& super = index.superStorage[b >> SUPERBLOCK_SHIFT];
+            if ((b & ((std::size_t(1) << SUPERBLOCK_SHIFT) - 1)) == 0) {
+                std::copy(counts, counts + 4, super.counts);
+            }
+            for (unsigned c = 0; c < 4; ++c) {
+                index.blockStorage[b].counts[c] = static_cast<std::uint32_t>(counts[c] - super.counts[c]);
+            }
+        }
+        if (r % SAMPLE_BITS_PER_BLOCK == 0) {
+            index.sampleBitStorage[r / SAMPLE_BITS_PER_BLOCK].rank = sampled;
+        }
+        if (r == n) break;
+
+        std::size_t pos = sa[r];
+        unsigned symbol;
+        if (pos == 0) {
+            symbol = 5;
+            index.header.dollarRow = r;
+        } else if (text.isN(pos - 1)) {
+            symbol = 4;
+            index.exceptionStorage.push_back(r);
+        } else {
+            symbol = text.code(pos - 1);
+            std::size_t offset = r % BASES_PER_BLOCK;
+            index.blockStorage[r / BASES_PER_BLOCK].bases[offset / 32] |=
+                static_cast<std::uint64_t>(symbol) << (2 * (offset % 32));
+        }
+        ++counts[symbol];
+
+        if (pos % sampleRate == 0) {
+            std::size_t bit = r % SAMPLE_BITS_PER_BLOCK;
+            index.sampleBitStorage[r / SAMPLE_BITS_PER_BLOCK].bits[bit / 64] |= std::uint64_t(1) << (bit % 64);
+            index.samples.set(sampled++, pos / sampleRate);
+        }
+    }
+
+    // Ordre des suffixes : '$' < A < C < G < N < T (ordre ASCII, comme SuffixArray)
+    std::uint64_t* first = index.header.firstRank;
+    first[5] = 0;
+    first[0] = 1;
+    first[1] = first[0] + counts[0];
+    first[2] = first[1] + counts[1];
+    first[4] = first[2] + counts[2];
+    first[3] = first[4] + counts[4];
+
+    index.sequence = suffixArray.releaseSequence();
+    index.publish();
+    return index;
+}
+
+std::size_t FMIndex::exceptionsBefore(std::size_t i) const {
+    // Les exceptions avant le bloc se déduisent des compteurs : tout ce qui n'est pas ACGT
+    std::size_t b = i / BASES_PER_BLOCK;
+    std::size_t start = b * BASES_PER_BLOCK;
+    const OccBlock& block = blocks[b];
+    const SuperBlock& super = superBlocks[b >> SUPERBLOCK_SHIFT];
+    std::size_t acgt = 0;
+    for (unsigned c = 0; c < 4; ++c) {
+        acgt += super.counts[c] + block.counts[c];
+    }
+    std::size_t k = start - acgt - (header.dollarRow < start ? 1 : 0);
+    while (k < exceptionCount && exceptions[k] < i) {
+        ++k;
+    }
+    return k;
+}
+
+unsigned FMIndex::symbolAt(std::size_t r) const {
+    if (r == header.dollarRow) return 5;
+    std::size_t offset = r % BASES_PER_BLOCK;
+    unsigned code = static_cast<unsigned>(
+        blocks[r / BASES_PER_BLOCK].bases[offset / 32] >> (2 * (offset % 32))) & 3u;
+    if (code == 0 && exceptionCount > 0 &&
+        std::binary_search(exceptions, exceptions + exceptionCount, static_cast<std::uint64_t>(r))) {
+        return 4;
+    }
+    return code;
+}
+
+std::size_t FMIndex::occ(unsigned symbol, std::size_t i) const {
+    if (symbol == 5) return header.dollarRow < i ? 1 : 0;
+    if (symbol == 4) return exceptionsBefore(i);
+
+    std::size_t b = i / BASES_PER_BLOCK;
+    std::size_t start = b * BASES_PER_BLOCK;
+    const OccBlock& block = blocks[b];
+    std::size_t count = superBlocks[b >> SUPERBLOCK_SHIFT].counts[symbol] + block.counts[symbol];
+
+    const std::uint64_t pattern = symbol * LOW_BITS;
+    std::size_t offset = i - start;
+    std::size_t w = 0;
+    for (; (w + 1) * 32 <= offset; ++w) {
+        count += std::popcount(matchingSymbols(block.bases[w], pattern));
+    }
+    std::size_t rest = offset - w * 32;
+    if (rest > 0) {
+        std::uint64_t mask = (std::uint64_t(1) << (2 * rest)) - 1;
+        count += std::popcount(matchingSymbols(block.bases[w], pattern) & mask);
+    }
+
+    // '$' et 'N' sont codés comme 'A' : on retire ceux du bloc situés avant i
+    if (symbol == 0 && i > start) {
+        if (header.dollarRow >= start && header.dollarRow < i) --count;
+        count -= exceptionsBefore(i) - exceptionsBefore(start);
+    }
+    return count;
+}
+
+std::size_t FMIndex::sampleRank(std::size_t r) const {
+    const SampleBlock& block = sampleBits[r / SAMPLE_BITS_PER_BLOCK];
+    std::size_t bit = r % SAMPLE_BITS_PER_BLOCK;
+    std::size_t rank = block.rank;
+    for (std::size_t w = 0; w < bit / 64; ++w) {
+        rank += std::popcount(block.bits[w]);
+    }
+    std::uint64_t mask = (std::uint64_t(1) << (bit % 64)) - 1;
+    return rank + std::popcount(block.bits[bit / 64] & mask);
+}
+
+std::pair<std::size_t, std::size_t> FMIndex::findInterval(std::string_view motif) const {
+    std::size_t lo = 0, hi = header.textLength;
+    for (std::size_t i = motif.length(); i-- > 0;) {
+        unsigned symbol;
+        switch (motif[i]) {
+            case 'A': symbol = 0; break;
+            case 'C': symbol = 1; break;
+            case 'G': symbol = 2; break;
+            case 'T': symbol = 3; break;
+            case 'N': symbol = 4; break;
+            default: return {0, 0};
+        }
+        lo = header.firstRank[symbol] + occ(symbol, lo);
+        hi = header.firstRank[symbol] + occ(symbol, hi);
+        if (lo >= hi) return {lo, lo};
+    }
+    return {lo, hi};
+}
+
+std::size_t FMIndex::locate(std::size_t r) const {
+    // La position 0 est toujours échantillonnée : la remontée ne franchit jamais '$'
+    std::size_t steps = 0;
+    while (!isSampled(r)) {
+        r = lf(r);
+        ++steps;
+    }
+    return samples[sampleRank(r)] * header.sampleRate + steps;
+}
+
+std::size_t FMIndex::countOccurrences(const std::string& motif) const {
+    if (motif.empty()) {
+        return 0;
+    }
+    auto [lower, upper] = findInterval(motif);
+    return upper - lower;
+}
+
+std::vector<std::size_t> FMIndex::findOccurrences(const std::string& motif) const {
+    std::vector<std::size_t> occurrences;
+    if (motif.empty()) return occurrences;
+
+    auto [lower, upper] = findInterval(motif);
+    occurrences.reserve(upper - lower);
+    for (std::size_t r = lower; r < upper; ++r) {
+        occurrences.push_back(locate(r));
+    }
+    return occurrences;
+}
+
+std::size_t FMIndex::memoryBytes() const {
+    return sequence.memoryBytes() + blockCount * sizeof(OccBlock) +
+           ((blockCount >> SUPERBLOCK_SHIFT) + 1) * sizeof(SuperBlock) +
+           exceptionCount * sizeof(std::uint64_t) + sampleBlockCount * sizeof(SampleBlock) +
+           samples.sizeBytes();
+}
+
+void FMIndex::save(IndexFile::Writer& writer) const {
+    writer.addSection(IndexFile::PACKED_TEXT, sequence.wordData(),
+                      sequence.wordCount() * sizeof(std::uint64_t));
+    writer.addSection(IndexFile::N_RUNS, sequence.runData(),
+                      sequence.runSize() * sizeof(PackedSequence::NRun));
+    writer.addSection(IndexFile::FM_HEADER, &header, sizeof(Header));
+    writer.addSection(IndexFile::FM_OCC, blocks, blockCount * sizeof(OccBlock));
+    writer.addSection(IndexFile::FM_SUPERBLOCKS, superBlocks,
+                      ((blockCount >> SUPERBLOCK_SHIFT) + 1) * sizeof(SuperBlock));
+    writer.addSection(IndexFile::FM_EXCEPTIONS, exceptions, exceptionCount * sizeof(std::uint64_t));
+    writer.addSection(IndexFile::FM_SAMPLE_BITS, sampleBits, sampleBlockCount * sizeof(SampleBlock));
+    writer.addSection(IndexFile::FM_SAMPLES, samples.data(), samples.sizeBytes());
+}
+
+FMIndex FMIndex::load(const IndexFile::Reader& reader) {
+    FMIndex index;
+    index.mapping = reader.getMapping();
+
+    std::string_view textSection = reader.getSection(IndexFile::PACKED_TEXT);
+    std::string_view runSection = reader.getSection(IndexFile::N_RUNS);
+    std::string_view headerSection = reader.getSection(IndexFile::FM_HEADER);
+    std::string_view occSection = reader.getSection(IndexFile::FM_OCC);
+    std::string_view superSection = reader.getSection(IndexFile::FM_SUPERBLOCKS);
+    std::string_view exceptionSection = reader.getSection(IndexFile::FM_EXCEPTIONS);
+    std::string_view sampleBitSection = reader.getSection(IndexFile::FM_SAMPLE_BITS);
+    std::string_view sampleSection = reader.getSection(IndexFile::FM_SAMPLES);
+
+    if (headerSection.size() != sizeof(Header)) {
+        throw std::runtime_error("Erreur : En-tête de l'index FM incohérent");
+    }
+    std::memcpy(&index.header, headerSection.data(), sizeof(Header));
+
+    const std::size_t bases = reader.getMetadata().referenceLength;
+    const std::size_t n = bases + 1;
+    const std::size_t rate = index.header.sampleRate;
+    const std::size_t blockN = n / BASES_PER_BLOCK + 1;
+    const std::size_t sampleCount = rate == 0 ? 0 : (n - 1) / rate + 1;
+    const std::size_t width = sampleCount == 0 ? 0 : sampleSection.size() / sampleCount;
+    if (index.header.textLength != n || rate == 0 ||
+        textSection.size() != (bases + PackedSequence::BASES_PER_WORD - 1) / PackedSequence::BASES_PER_WORD * sizeof(std::uint64_t) ||
+        runSection.size() % sizeof(PackedSequence::NRun) != 0 ||
+        occSection.size() != blockN * sizeof(OccBlock) ||
+        superSection.size() != ((blockN >> SUPERBLOCK_SHIFT) + 1) * sizeof(SuperBlock) ||
+        exceptionSection.size() % sizeof(std::uint64_t) != 0 ||
+        sampleBitSection.size() != (n / SAMPLE_BITS_PER_BLOCK + 1) * sizeof(SampleBlock) ||
+        (width != 4 && width != 5 && width != 8) || sampleSection.size() != sampleCount * width) {
+        throw std::runtime_error("Erreur : Tables de l'index FM incohérentes");
+    }
+
+    // Les sections sont alignées sur 64 octets : lecture directe dans la projection
+    index.sequence = PackedSequence::view(
+        reinterpret_cast<const std::uint64_t*>(textSection.data()), bases,
+        reinterpret_cast<const PackedSequence::NRun*>(runSection.data()),
+        runSection.size() / sizeof(PackedSequence::NRun));
+    index.blocks = reinterpret_cast<const OccBlock*>(occSection.data());
+    index.blockCount = blockN;
+    index.superBlocks = reinterpret_cast<const SuperBlock*>(superSection.data());
+    index.exceptions = reinterpret_cast<const std::uint64_t*>(exceptionSection.data());
+    index.exceptionCount = exceptionSection.size() / sizeof(std::uint64_t);
+    index.sampleBits = reinterpret_cast<const SampleBlock*>(sampleBitSection.data());
+    index.sampleBlockCount = sampleBitSection.size() / sizeof(SampleBlock);
+    index.samples = IndexArray::view(sampleSection.data(), sampleCount, static_cast<unsigned>(width));
+    return index;
+}
@@ -0,0 +1,120 @@
+#include "FastaIndex.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstring>
+
+namespace {
+
+// Séquence en cours de parcours (build)
+struct OpenEntry {
+    FastaIndexEntry entry{};
+    bool started = false;    // au moins une ligne de bases
+    bool lastLine = false;   // une ligne courte ou vide a été vue : plus aucune base n'est admise
+};
+
+std::runtime_error lineLengthError(const std::string& name) {
+    return std::runtime_error("Erreur : Les lignes de la séquence " + name +
+                              " n'ont pas toutes la même longueur (index .fai impossible)");
+}
+
+} // namespace
+
+FastaIndex FastaIndex::build(const std::string& fastaPath) {
+    MappedFile mapping(fastaPath);
+    const char* data = mapping.getData();
+    const std::size_t size = mapping.getSize();
+
+    FastaIndex index;
+    OpenEntry current;
+    bool inSequence = false;
+    for (std::size_t pos = 0; pos < size; ) {
+        const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        const std::size_t end = newline == nullptr ? size : static_cast<std::size_t>(newline - data);
+        const std::size_t next = newline == nullptr ? size : end + 1;
+        std::size_t bases = end - pos;
+        if (bases > 0 && data[end - 1] == '\r') --bases;
+
+        if (bases > 0 && data[pos] == '>') {
+            if (inSequence) index.add(current.entry);
+            current = OpenEntry{};
+            const std::string header(data + pos + 1, bases - 1);
+            current.entry.name = header.substr(0, header.find_first_of(" \t"));
+            current.entry.offset = next;
+            inSequence = true;
+        } else if (bases == 0) {
+            // Ligne vide : avant la première ligne de bases, la séquence commence après elle ;
+            // ensuite, plus aucune base n'est admise
+            if (inSequence && current.started) current.lastLine = true;
+            else if (inSequence) current.entry.offset = next;
+        } else if (!inSequence) {
+            throw std::runtime_error("Erreur : Le fichier " + fastaPath + " ne commence pas par un header (>)");
+        } else {
+            const std::size_t width = next - pos;
+            if (!current.started) {
+                current.entry.lineBases = bases;
+                current.entry.lineWidth = width;
+                current.started = true;
+            } else if (current.lastLine || bases > current.entry.lineBases ||
+                       (bases == current.entry.lineBases && width != current.entry.lineWidth && newline != nullptr)) {
+                throw lineLengthError(current.entry.name);
+            }
+            if (bases < current.entry.lineBases) current.lastLine = true;
+            current.entry.length += bases;
+        }
+        pos = next;
+    }
+    if (inSequence) index.add(current.entry);
+    return index;
+}
+
+FastaIndex FastaIndex::load(const std::string& indexPath) {
+    std::ifstream file(indexPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + indexPath);
+    }
+    FastaIndex index;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        std::istringstream fields(line);
+        FastaIndexEntry entry{};
+        if (!std::getline(fields, entry.name, '\t') ||
+            !(fields >> entry.length >> entry.offset >> entry.lineBases >> entry.lineWidth) ||
+            (entry.length > 0 && (entry.lineBases == 0 || entry.lineWidth < entry.lineBases))) {
+            throw std::runtime_error("Erreur : Ligne invalide dans l'index " + indexPath + " : " + line);
+        }
+        index.add(std::move(entry));
+    }
+    return index;
+}
+
+void FastaIndex::save(const std::string& indexPath) const {
+    std::ofstream file(indexPath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + indexPath);
+    }
+    for (const FastaIndexEntry& entry : entries) {
+        file << entry.name << '\t' << entry.length << '\t' << entry.offset << '\t'
+             << entry.lineBases << '\t' << entry.lineWidth << '\n';
+    }
+    if (!file) {
+        throw std::runtime_error("Erreur : Écriture impossible du fichier " + indexPath);
+    }
+}
+
+const FastaIndexEntry& FastaIndex::find(const std::string& name) const {
+    auto it = positions.find(name);
+    if (it == positions.end()) {
+        throw std::invalid_argument("Séquence absente de l'index : " + name);
+    }
+    return entries[it->second];
+}
+
+void FastaIndex::add(FastaIndexEntry entry) {
+    if (!positions.emplace(entry.name, entries.size()).second) {
+        throw std::runtime_error("Erreur : Nom de séquence en double dans le FASTA : " + entry.name);
+    }
+    entries.push_back(std::move(entry));
+}
@@ -2,6 +2,9 @@
 //./fasta
 #include "FastaParser.h"
 #include "SequenceParser.h"
+#include "GzipReader.h"
+#include "FormatFileDetector.h"
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -10,8 +13,8 @@
 FastaParser::FastaParser(const std::string& filePath) : filePath(filePath) {}
 
 bool FastaParser::loadFile() {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    InputFile file(filePath);
+    if (!file.isOpen()) {
         std::cerr << "Erreur : Impossible d'ouvrir le fichier " << filePath << std::endl;
         return false;
     }
@@ -64,15 +67,14 @@ bool FastaParser::loadFile() {
         std::cerr << "..." << spaceWarnings - 5 << " avertissements supplémentaires sur les espaces\n";
     }
 
-    file.close();
     return true;
 }
 
 bool FastaParser::processSequences(
     const std::function<void(const std::string& header,
                              const std::string& sequence)>& callback) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
+    InputFile file(filePath);
+    if (!file.isOpen()) {
         std::cerr << "Erreur : Impossible d'ouvrir le fichier " << filePath << std::endl;
         return false;
     }
@@ -105,8 +107,7 @@ bool FastaParser::processSequences(
             }
         } else {
             std::cerr << "Erreur: Le fichier ne commence pas par un header (> ou ;)" << std::endl;
-            file.close();
-            return false;
+                    return false;
         }
     }
 
@@ -118,12 +119,57 @@ bool FastaParser::processSequences(
         std::cerr << "..." << spaceWarnings - 5 << " avertissements supplémentaires sur les espaces\n";
     }
 
-    file.close();
     return true;
 }
 
 
 
+const FastaIndex& FastaParser::loadIndex() {
+    if (index) return *index;
+    if (FormatFileDetector::detectCompression(filePath) != FormatFileDetector::NONE) {
+        throw std::runtime_error("Erreur : Index .fai impossible sur un fichier compressé " + filePath);
+    }
+    // Un .fai plus ancien que le FASTA est ignoré (fichier modifié depuis)
+    const std::string indexPath = filePath + ".fai";
+    std::error_code error;
+    const auto indexTime = std::filesystem::last_write_time(indexPath, error);
+    if (!error && indexTime >= std::filesystem::last_write_time(filePath)) {
+        index = std::make_unique<FastaIndex>(FastaIndex::load(indexPath));
+    } else {
+        index = std::make_unique<FastaIndex>(FastaIndex::build(filePath));
+    }
+    return *index;
+}
+
+void FastaParser::writeIndex() {
+    index = std::make_unique<FastaIndex>(FastaIndex::build(filePath));
+    index->save(filePath + ".fai");
+}
+
+std::string FastaParser::fetch(const std::string& contig, std::size_t start, std::size_t end) {
+    const FastaIndexEntry& entry = loadIndex().find(contig);
+    end = std::min(end, entry.length);
+    if (start > end) {
+        throw std::invalid_argument("Intervalle invalide pour " + contig + " : début après la fin");
+    }
+    if (!mapping) mapping = std::make_unique<MappedFile>(filePath);
+
+    // Une copie par ligne : les fins de ligne sont sautées
+    std::string bases;
+    bases.reserve(end - start);
+    for (std::size_t pos = start; pos < end; ) {
+        const std::size_t column = pos % entry.lineBases;
+        const std::size_t count = std::min(entry.lineBases - column, end - pos);
+        const std::uint64_t byte = entry.offset + (pos / entry.lineBases) * entry.lineWidth + column;
+        if (byte + count > mapping->getSize()) {
+            throw std::runtime_error("Erreur : Index .fai incohérent avec le fichier " + filePath);
+        }
+        bases.append(mapping->getData() + byte, count);
+        pos += count;
+    }
+    return bases;
+}
+
 bool FastaParser::validate() const {
  // 1. Vérifier que les données sont chargées
  if (sequences.empty() || headers.empty()) {
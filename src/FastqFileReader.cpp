@@ -12,9 +12,9 @@
 FastqFileReader::FastqFileReader(const std::string& filePath) : filePath(filePath) {}
 
 bool FastqFileReader::loadFile() {
-    std::ifstream file(filePath);
+    InputFile file(filePath, numThreads);
 
-    if (!file.is_open()) {
+    if (!file.isOpen()) {
         throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
     }
     headers.clear();
@@ -60,21 +60,28 @@ bool FastqFileReader::processSequences(
     const std::function<void(const std::string&,
                              const std::string&,
                               const std::string&)>& callback){
-    std::ifstream file(filePath);
-    if (!file.is_open()) return false;
-
-    std::string header, sequence, separator, quality;
-    while(std::getline(file, header)) {
-        if(isSequenceStart(header)) {
-            if(!std::getline(file, sequence)) break;
-            std::getline(file, separator);
-            if(!std::getline(file, quality)) break;
+    if (filePath != "-" && !std::ifstream(filePath).is_open()) return false;
+
+    // Les chaînes sont réutilisées d'un enregistrement à l'autre (pas de réallocation)
+    std::string header, sequence, quality;
+    forEachRecord([&](std::string_view h, std::string_view s, std::string_view q) {
+        header.assign(h);
+        sequence.assign(s);
+        quality.assign(q);
+        callback(header, sequence, quality);
+    });
+    return true;
+}
 
-            callback(header, sequence, quality);
+bool FastqFileReader::nextRecord(std::string& header, std::string& sequence, std::string& quality) {
+    if (!recordStream) {
+        recordStream = std::make_unique<InputFile>(filePath, numThreads);
+        if (!recordStream->isOpen()) {
+            throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
         }
+        isStreamMode = true;
     }
-    isStreamMode = true;
-    return true;
+    return readRecord(*recordStream, header, sequence, quality);
 }
 
 bool FastqFileReader::validate() const {
@@ -172,6 +179,19 @@ size_t FastqFileReader::countSequences() const {
 
 //Méthode internes
 
+bool FastqFileReader::readRecord(std::istream& in, std::string& header,
+                                 std::string& sequence, std::string& quality) const {
+    std::string separator;
+    while(std::getline(in, header)) {
+        if(isSequenceStart(header)) {
+            if(!std::getline(in, sequence)) return false;
+            std::getline(in, separator);
+            return static_cast<bool>(std::getline(in, quality));
+        }
+    }
+    return false;
+}
+
 bool FastqFileReader::isSequenceStart(const std::string& line) const {
     return !line.empty() && line[0] == '@';
 }
@@ -0,0 +1,72 @@
+#include "FastqScanner.h"
+#include <stdexcept>
+#include <cerrno>
+#include <fcntl.h>     // open
+#include <sys/stat.h>  // stat
+#include <unistd.h>    // read, close
+
+FastqScanner::FastqScanner(const std::string& filePath, unsigned numThreads)
+    : filePath(filePath), numThreads(numThreads) {}
+
+bool FastqScanner::isMappable() const {
+    if (filePath == "-") return false;
+    struct stat info;
+    if (::stat(filePath.c_str(), &info) != 0) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
+    }
+    return S_ISREG(info.st_mode) && FormatFileDetector::detectCompression(filePath) == FormatFileDetector::NONE;
+}
+
+const char* FastqScanner::findRecordStart(const char* begin, const char* from, const char* end) {
+    // Début de la première ligne complète à partir de from
+    const char* cursor = from;
+    if (cursor > begin && cursor[-1] != '\n') {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+        if (newline == nullptr) return end;
+        cursor = newline + 1;
+    }
+
+    std::string_view lines[4];
+    while (cursor < end) {
+        const char* candidate = cursor;
+        const char* next = cursor;
+        std::size_t count = 0;
+        while (count < 4 && nextLine(next, end, true, lines[count])) ++count;
+        if (count == 4 && !lines[0].empty() && lines[0][0] == '@' &&
+            !lines[2].empty() && lines[2][0] == '+' &&
+            (lines[2].size() == 1 || lines[2].substr(1) == lines[0].substr(1)) &&
+            lines[1].size() == lines[3].size()) {
+            return candidate;
+        }
+        // Ligne suivante
+        cursor = candidate;
+        nextLine(cursor, end, true, lines[0]);
+    }
+    return end;
+}
+
+FastqScanner::Descriptor::Descriptor(const std::string& filePath) : filePath(filePath) {
+    if (filePath == "-") {
+        fd = STDIN_FILENO;
+        return;
+    }
+    fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
+    }
+    ownsDescriptor = true;
+}
+
+FastqScanner::Descriptor::~Descriptor() {
+    if (ownsDescriptor) ::close(fd);
+}
+
+std::size_t FastqScanner::Descriptor::read(char* buffer, std::size_t size) {
+    for (;;) {
+        const ssize_t received = ::read(fd, buffer, size);
+        if (received >= 0) return static_cast<std::size_t>(received);
+        if (errno != EINTR) {
+            throw std::runtime_error("Erreur : Lecture impossible du fichier " + filePath);
+        }
+    }
+}
@@ -1,27 +1,37 @@
 #include "FormatFileDetector.h"
+#include "GzipReader.h"
 #include <fstream>
 
 FormatFileDetector::Format FormatFileDetector::detect(const std::string& filePath){
     
-    std::ifstream file(filePath);
-    if (!file) return UNKNOWN;
-
-    
-    // Vérifier si le fichier est vide
-    file.seekg(0, std::ios::end);
-    if (file.tellg() == 0) {
-        return UNKNOWN;
-    }
-    file.seekg(0, std::ios::beg);
+    InputFile file(filePath);
+    if (!file.isOpen()) return UNKNOWN;
 
+    // Fichier vide : aucune ligne
     std::string firstLine;
-    std::getline(file, firstLine);
+    if (!std::getline(file, firstLine)) return UNKNOWN;
 
     if (firstLine.empty()) return UNKNOWN;
     return (firstLine[0] == '>' || firstLine[0] == ';') ? FASTA: 
            (firstLine[0] == '@') ? FASTQ : UNKNOWN;
 }
 
+FormatFileDetector::Compression FormatFileDetector::detectCompression(const std::string& filePath) {
+    if (filePath == "-") return NONE;
+    std::ifstream file(filePath, std::ios::binary);
+    unsigned char header[18] = {};
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    const std::streamsize length = file.gcount();
+    if (length < 2 || header[0] != 0x1f || header[1] != 0x8b) return NONE;
+
+    // BGZF : FLG.FEXTRA, XLEN = 6 et sous-champ 'B' 'C' de longueur 2
+    const bool blockCompressed = length == 18 && (header[3] & 0x04) != 0 &&
+                                 header[10] == 6 && header[11] == 0 &&
+                                 header[12] == 'B' && header[13] == 'C' &&
+                                 header[14] == 2 && header[15] == 0;
+    return blockCompressed ? BGZF : GZIP;
+}
+
 std::string FormatFileDetector::formatToString(Format format) {
     switch (format) {
         case FASTA: return "FASTA";
@@ -0,0 +1,229 @@
+#include "GzipReader.h"
+#include "FormatFileDetector.h"
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace {
+
+// En-tête gzip fixe : ID1 ID2 CM FLG MTIME(4) XFL OS XLEN(2), XLEN si FLG.FEXTRA
+constexpr std::size_t GZIP_HEADER_SIZE = 12;
+constexpr unsigned char FLAG_EXTRA = 0x04;
+// CRC32 et ISIZE en fin de bloc
+constexpr std::size_t GZIP_TRAILER_SIZE = 8;
+// Taille maximale d'un bloc BGZF décompressé
+constexpr std::size_t BGZF_MAX_BLOCK_SIZE = 1 << 16;
+
+std::uint32_t readLittleEndian32(const unsigned char* bytes) {
+    return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) |
+           (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+}
+
+std::uint16_t readLittleEndian16(const unsigned char* bytes) {
+    return static_cast<std::uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+// Bloc BGZF lu : données deflate brutes dans le lot compressé, position dans la sortie
+struct Block {
+    std::size_t dataOffset;
+    std::size_t dataSize;
+    std::size_t outputOffset;
+    std::uint32_t size;
+    std::uint32_t crc;
+};
+
+// Décompresse un bloc (deflate brut) et vérifie sa taille et son CRC32
+bool inflateBlock(const unsigned char* data, std::size_t dataSize, char* target, const Block& block) {
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+    stream.next_in = const_cast<unsigned char*>(data);
+    stream.avail_in = static_cast<uInt>(dataSize);
+    stream.next_out = reinterpret_cast<unsigned char*>(target);
+    stream.avail_out = block.size;
+    const int status = inflate(&stream, Z_FINISH);
+    const bool complete = status == Z_STREAM_END && stream.total_out == block.size;
+    inflateEnd(&stream);
+    return complete &&
+           crc32(0L, reinterpret_cast<const unsigned char*>(target), block.size) == block.crc;
+}
+
+} // namespace
+
+GzipReader::GzipReader(const std::string& filePath, unsigned numThreads)
+    : filePath(filePath), numThreads(numThreads == 0 ? 1 : numThreads) {
+    blockCompressed = FormatFileDetector::detectCompression(filePath) == FormatFileDetector::BGZF;
+    file = std::fopen(filePath.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
+    }
+    if (!blockCompressed) {
+        // 15 + 32 : fenêtre maximale, en-tête gzip ou zlib détecté par zlib
+        if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK) {
+            std::fclose(file);
+            throw std::runtime_error("Erreur : Initialisation de zlib impossible");
+        }
+        streamReady = true;
+        input.resize(INPUT_BUFFER_SIZE);
+    }
+}
+
+GzipReader::~GzipReader() {
+    if (streamReady) inflateEnd(&stream);
+    if (file != nullptr) std::fclose(file);
+}
+
+std::size_t GzipReader::read(char* buffer, std::size_t size) {
+    std::size_t copied = 0;
+    while (copied < size) {
+        if (outputPos == output.size() && !refill()) break;
+        const std::size_t count = std::min(size - copied, output.size() - outputPos);
+        std::memcpy(buffer + copied, output.data() + outputPos, count);
+        outputPos += count;
+        copied += count;
+    }
+    return copied;
+}
+
+bool GzipReader::refill() {
+    output.clear();
+    outputPos = 0;
+    // Un bloc (ou un tampon) peut être vide : on continue jusqu'à des données ou la fin
+    while (!finished && output.empty()) {
+        if (blockCompressed ? !refillBlocks() : !refillStream()) finished = true;
+    }
+    return !output.empty();
+}
+
+bool GzipReader::refillStream() {
+    output.resize(OUTPUT_BUFFER_SIZE);
+    stream.next_out = reinterpret_cast<unsigned char*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    while (stream.avail_out > 0) {
+        if (stream.avail_in == 0) {
+            const std::size_t received = std::fread(input.data(), 1, input.size(), file);
+            if (received == 0) {
+                if (std::ferror(file)) {
+                    throw std::runtime_error("Erreur : Lecture impossible du fichier " + filePath);
+                }
+                // total_in est remis à zéro à chaque fin de membre : non nul, le membre est incomplet
+                if (stream.total_in > 0) {
+                    throw std::runtime_error("Erreur : Fichier gzip tronqué " + filePath);
+                }
+                output.resize(output.size() - stream.avail_out);
+                return !output.empty();
+            }
+            stream.next_in = input.data();
+            stream.avail_in = static_cast<uInt>(received);
+        }
+
+        const int status = inflate(&stream, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+            // Membre suivant (gzip concaténés) ; des octets de remplissage après le dernier sont ignorés
+            if (stream.avail_in > 0 && stream.next_in[0] != 0x1f) {
+                output.resize(output.size() - stream.avail_out);
+                finished = true;
+                return true;
+            }
+            inflateReset(&stream);
+        } else if (status != Z_OK && status != Z_BUF_ERROR) {
+            throw std::runtime_error("Erreur : Fichier gzip corrompu " + filePath);
+        }
+    }
+    return true;
+}
+
+bool GzipReader::readExactly(unsigned char* target, std::size_t size) {
+    const std::size_t received = std::fread(target, 1, size, file);
+    if (received == size) return true;
+    if (received == 0 && !std::ferror(file)) return false;
+    throw std::runtime_error("Erreur : Fichier BGZF tronqué " + filePath);
+}
+
+bool GzipReader::refillBlocks() {
+    // Lecture séquentielle d'un lot de blocs, données compressées mises bout à bout dans input
+    std::vector<unsigned char>& compressed = input;
+    compressed.clear();
+    std::vector<Block> blocks;
+    std::size_t outputSize = 0;
+    const std::size_t maxBlocks = numThreads * BLOCKS_PER_THREAD;
+    unsigned char header[GZIP_HEADER_SIZE];
+    std::vector<unsigned char> extra(1 << 16);
+
+    while (blocks.size() < maxBlocks && readExactly(header, GZIP_HEADER_SIZE)) {
+        const std::size_t extraLength = readLittleEndian16(header + 10);
+        if (header[0] != 0x1f || header[1] != 0x8b || (header[3] & FLAG_EXTRA) == 0) {
+            throw std::runtime_error("Erreur : Bloc BGZF invalide dans " + filePath);
+        }
+        if (extraLength > 0 && !readExactly(extra.data(), extraLength)) {
+            throw std::runtime_error("Erreur : Fichier BGZF tronqué " + filePath);
+        }
+        // Sous-champ BC : taille totale du bloc - 1
+        std::size_t blockSize = 0;
+        for (std::size_t pos = 0; pos + 4 <= extraLength; ) {
+            const std::size_t fieldLength = readLittleEndian16(extra.data() + pos + 2);
+            if (extra[pos] == 'B' && extra[pos + 1] == 'C' && fieldLength == 2 && pos + 6 <= extraLength) {
+                blockSize = static_cast<std::size_t>(readLittleEndian16(extra.data() + pos + 4)) + 1;
+            }
+            pos += 4 + fieldLength;
+        }
+        if (blockSize < GZIP_HEADER_SIZE + extraLength + GZIP_TRAILER_SIZE) {
+            throw std::runtime_error("Erreur : Bloc BGZF invalide dans " + filePath);
+        }
+
+        const std::size_t remaining = blockSize - GZIP_HEADER_SIZE - extraLength;
+        const std::size_t offset = compressed.size();
+        compressed.resize(offset + remaining);
+        if (!readExactly(compressed.data() + offset, remaining)) {
+            throw std::runtime_error("Erreur : Fichier BGZF tronqué " + filePath);
+        }
+        const unsigned char* trailer = compressed.data() + offset + remaining - GZIP_TRAILER_SIZE;
+        Block block{offset, remaining - GZIP_TRAILER_SIZE, outputSize,
+                    readLittleEndian32(trailer + 4), readLittleEndian32(trailer)};
+        if (block.size > BGZF_MAX_BLOCK_SIZE) {
+            throw std::runtime_error("Erreur : Bloc BGZF invalide dans " + filePath);
+        }
+        outputSize += block.size;
+        blocks.push_back(block);
+    }
+    if (blocks.empty()) return false;
+
+    // Décompression parallèle, chaque bloc à sa place dans la sortie
+    output.resize(outputSize);
+    const long blockCount = static_cast<long>(blocks.size());
+    bool valid = true;
+    #pragma omp parallel for num_threads(numThreads) schedule(dynamic) reduction(&& : valid)
+    for (long i = 0; i < blockCount; ++i) {
+        const Block& block = blocks[i];
+        valid = inflateBlock(compressed.data() + block.dataOffset, block.dataSize,
+                             output.data() + block.outputOffset, block) && valid;
+    }
+    if (!valid) {
+        throw std::runtime_error("Erreur : Bloc BGZF corrompu dans " + filePath);
+    }
+    return true;
+}
+
+GzipStreamBuf::GzipStreamBuf(const std::string& filePath, unsigned numThreads)
+    : reader(filePath, numThreads), buffer(1 << 16) {}
+
+GzipStreamBuf::int_type GzipStreamBuf::underflow() {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+    const std::size_t received = reader.read(buffer.data(), buffer.size());
+    if (received == 0) return traits_type::eof();
+    setg(buffer.data(), buffer.data(), buffer.data() + received);
+    return traits_type::to_int_type(*gptr());
+}
+
+InputFile::InputFile(const std::string& filePath, unsigned numThreads) : std::istream(nullptr) {
+    if (FormatFileDetector::detectCompression(filePath) == FormatFileDetector::NONE) {
+        open = fileBuffer.open(filePath, std::ios::in) != nullptr;
+        rdbuf(&fileBuffer);
+    } else {
+        gzipBuffer = std::make_unique<GzipStreamBuf>(filePath, numThreads);
+        open = true;
+        rdbuf(gzipBuffer.get());
+    }
+    if (!open) setstate(std::ios::failbit);
+}
@@ -0,0 +1,65 @@
+#include "IndexArray.h"
+#include <algorithm>
+
+void IndexArray::assign(std::size_t n, unsigned w) {
+    width = w;
+    count = n;
+    storage.assign(n * w, 0);
+    bytes = storage.data();
+}
+
+IndexArray IndexArray::view(const void* data, std::size_t n, unsigned w) {
+    IndexArray array;
+    array.bytes = static_cast<const unsigned char*>(data);
+    array.count = n;
+    array.width = w;
+    return array;
+}
+
+bool IndexArray::operator==(const IndexArray& other) const {
+    if (count != other.count) return false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if ((*this)[i] != other[i]) return false;
+    }
+    return true;
+}
+
+void CompactLcpArray::resize(std::size_t n) {
+    count = n;
+    smallStorage.assign(n, 0);
+    overflowStorage.clear();
+    finalize();
+}
+
+void CompactLcpArray::finalize() {
+    std::sort(overflowStorage.begin(), overflowStorage.end(),
+        [](const OverflowEntry& a, const OverflowEntry& b) { return a.position < b.position; });
+    small = smallStorage.data();
+    overflow = overflowStorage.data();
+    overflowCount = overflowStorage.size();
+}
+
+std::size_t CompactLcpArray::lookupOverflow(std::size_t i) const {
+    const OverflowEntry* end = overflow + overflowCount;
+    const OverflowEntry* it = std::lower_bound(overflow, end, i,
+        [](const OverflowEntry& entry, std::size_t position) { return entry.position < position; });
+    return (it != end && it->position == i) ? static_cast<std::size_t>(it->value) : OVERFLOW_MARK;
+}
+
+CompactLcpArray CompactLcpArray::view(const unsigned char* smallData, std::size_t n,
+                                      const OverflowEntry* overflowData, std::size_t overflowN) {
+    CompactLcpArray array;
+    array.small = smallData;
+    array.count = n;
+    array.overflow = overflowData;
+    array.overflowCount = overflowN;
+    return array;
+}
+
+bool CompactLcpArray::operator==(const CompactLcpArray& other) const {
+    if (count != other.count) return false;
+    for (std::size_t i = 0; i < count; ++i) {
+        if ((*this)[i] != other[i]) return false;
+    }
+    return true;
+}
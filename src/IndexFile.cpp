@@ -0,0 +1,115 @@
+#include "IndexFile.h"
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+namespace IndexFile {
+
+bool isIndexFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    if (!file.read(magic, sizeof(magic))) return false;
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// Arrondit un décalage au multiple de SECTION_ALIGNMENT supérieur
+static std::uint64_t alignOffset(std::uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+void Writer::addSection(Section id, const void* data, std::size_t size) {
+    sections.push_back({id, data, size});
+}
+
+void Writer::write(const std::string& filePath, const Metadata& metadata) const {
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Erreur : Impossible de créer le fichier d'index " + filePath);
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.sectionCount = static_cast<std::uint32_t>(sections.size());
+    header.metadata = metadata;
+
+    // Calcul des décalages de chaque section
+    std::vector<IndexSectionEntry> directory;
+    std::uint64_t offset = alignOffset(sizeof(IndexHeader) + sections.size() * sizeof(IndexSectionEntry));
+    for (const auto& section : sections) {
+        directory.push_back({section.id, 0, offset, section.size});
+        offset = alignOffset(offset + section.size);
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(directory.data()),
+               static_cast<std::streamsize>(directory.size() * sizeof(IndexSectionEntry)));
+
+    const char padding[SECTION_ALIGNMENT] = {};
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(directory[i].offset - position));
+        file.write(static_cast<const char*>(sections[i].data),
+                   static_cast<std::streamsize>(sections[i].size));
+    }
+
+    if (!file) {
+        throw std::runtime_error("Erreur : Écriture incomplète du fichier d'index " + filePath);
+    }
+}
+
+Reader::Reader(const std::string& filePath)
+    : mapping(std::make_shared<const MappedFile>(filePath)) {
+
+    const char* data = mapping->getData();
+    const std::size_t size = mapping->getSize();
+
+    if (size < sizeof(IndexHeader) || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Erreur : " + filePath + " n'est pas un fichier d'index");
+    }
+
+    IndexHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != VERSION) {
+        throw std::runtime_error("Erreur : Version d'index non supportée (" +
+                                 std::to_string(header.version) + ", attendue " +
+                                 std::to_string(VERSION) + ")");
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw std::runtime_error("Erreur : Ordre des octets de l'index incompatible avec cette machine");
+    }
+
+    const std::size_t directoryEnd = sizeof(IndexHeader) + header.sectionCount * sizeof(IndexSectionEntry);
+    if (directoryEnd > size) {
+        throw std::runtime_error("Erreur : Répertoire de sections tronqué dans " + filePath);
+    }
+    directory.resize(header.sectionCount);
+    std::memcpy(directory.data(), data + sizeof(IndexHeader), header.sectionCount * sizeof(IndexSectionEntry));
+
+    for (const auto& entry : directory) {
+        if (entry.offset > size || entry.size > size - entry.offset) {
+            throw std::runtime_error("Erreur : Section " + std::to_string(entry.id) +
+                                     " hors du fichier d'index " + filePath);
+        }
+    }
+    metadata = header.metadata;
+}
+
+bool Reader::hasSection(Section id) const {
+    for (const auto& entry : directory) {
+        if (entry.id == id) return true;
+    }
+    return false;
+}
+
+std::string_view Reader::getSection(Section id) const {
+    for (const auto& entry : directory) {
+        if (entry.id == id) {
+            return std::string_view(mapping->getData() + entry.offset, entry.size);
+        }
+    }
+    throw std::runtime_error("Erreur : Section " + std::to_string(id) + " absente de l'index");
+}
+
+} // namespace IndexFile
@@ -0,0 +1,198 @@
+#include "KmerHashTable.h"
+#include "MinimizerSketch.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+KmerHashTable::KmerHashTable(PackedSequence&& reference, std::size_t k, std::size_t step,
+                             std::size_t window)
+    : sequence(std::move(reference)) {
+    if (k == 0 || k > MAX_KMER_SIZE) {
+        throw std::invalid_argument("Taille de k-mer invalide pour la table de hachage (1 à 32)");
+    }
+    if (step == 0) step = 1;
+    header.kmerSize = k;
+    header.stepSize = window > 0 ? 1 : step;
+    header.windowSize = window;
+
+    const std::size_t bases = sequence.length();
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> entries;
+    if (window > 0) {
+        // Minimiseurs de la référence seulement
+        entries.reserve(2 * bases / (window + 1) + 1);
+        MinimizerSketch(k, window).forEach(bases,
+            [this](std::size_t i) { return sequence.isN(i) ? 4u : sequence.code(i); },
+            [&entries](std::size_t position, std::uint64_t code) { entries.emplace_back(code, position); });
+    } else {
+        // Codes glissants : (code, position) des k-mers ACGT aux positions multiples du pas
+        const std::uint64_t mask = k == 32 ? ~std::uint64_t(0) : (std::uint64_t(1) << (2 * k)) - 1;
+        entries.reserve(bases / step + 1);
+        std::uint64_t code = 0;
+        std::size_t valid = 0; // bases ACGT consécutives terminant en i
+        for (std::size_t i = 0; i < bases; ++i) {
+            if (sequence.isN(i)) {
+                valid = 0;
+                continue;
+            }
+            code = ((code << 2) | sequence.code(i)) & mask;
+            if (++valid >= k) {
+                std::size_t start = i + 1 - k;
+                if (start % step == 0) entries.emplace_back(code, start);
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end()); // par code, puis par position
+
+    // Début de chaque k-mer distinct dans entries
+    std::vector<std::size_t> firstEntry;
+    for (std::size_t e = 0; e < entries.size(); ++e) {
+        if (e == 0 || entries[e].first != entries[e - 1].first) firstEntry.push_back(e);
+    }
+    const std::size_t distinct = firstEntry.size();
+    firstEntry.push_back(entries.size());
+
+    header.bucketCount = 1;
+    while (header.bucketCount < distinct) header.bucketCount <<= 1;
+
+    // Tri par comptage des groupes selon leur case de hachage
+    std::vector<std::size_t> start(header.bucketCount + 1, 0);
+    for (std::size_t g = 0; g < distinct; ++g) {
+        ++start[bucketOf(entries[firstEntry[g]].first) + 1];
+    }
+    for (std::size_t b = 0; b < header.bucketCount; ++b) {
+        start[b + 1] += start[b];
+    }
+    bucketStart.assign(header.bucketCount + 1, IndexArray::widthFor(distinct));
+    for (std::size_t b = 0; b <= header.bucketCount; ++b) {
+        bucketStart.set(b, start[b]);
+    }
+    std::vector<std::size_t> order(distinct);
+    for (std::size_t g = 0; g < distinct; ++g) {
+        order[start[bucketOf(entries[firstEntry[g]].first)]++] = g;
+    }
+
+    // Groupes et positions rangés case par case ; un groupe sentinelle ferme le dernier
+    groupStorage.resize(distinct + 1);
+    positions.assign(entries.size(), IndexArray::widthFor(bases));
+    std::size_t out = 0;
+    for (std::size_t slot = 0; slot < distinct; ++slot) {
+        std::size_t g = order[slot];
+        groupStorage[slot] = {entries[firstEntry[g]].first, out};
+        for (std::size_t e = firstEntry[g]; e < firstEntry[g + 1]; ++e) {
+            positions.set(out++, entries[e].second);
+        }
+    }
+    groupStorage[distinct] = {0, out};
+
+    groups = groupStorage.data();
+    header.groupCount = groupStorage.size();
+    header.positionCount = entries.size();
+}
+
+bool KmerHashTable::encode(std::string_view kmer, std::uint64_t& code) {
+    code = 0;
+    unsigned invalid = 0;
+    for (char c : kmer) {
+        unsigned base = baseCode(c);
+        invalid |= base;
+        code = (code << 2) | (base & 3u);
+    }
+    return (invalid & 4u) == 0;
+}
+
+std::pair<std::size_t, std::size_t> KmerHashTable::lookup(std::uint64_t code) const {
+    std::size_t b = bucketOf(code);
+    for (std::size_t g = bucketStart[b], end = bucketStart[b + 1]; g < end; ++g) {
+        if (groups[g].code == code) {
+            return {groups[g].begin, groups[g + 1].begin};
+        }
+    }
+    return {0, 0};
+}
+
+std::vector<std::uint64_t> KmerHashTable::frequentCodes(std::size_t threshold) const {
+    // Le dernier groupe est la sentinelle qui ferme les positions du précédent
+    std::vector<std::uint64_t> codes;
+    for (std::size_t g = 0; g + 1 < header.groupCount; ++g) {
+        if ((groups[g + 1].begin - groups[g].begin) * header.stepSize > threshold) {
+            codes.push_back(groups[g].code);
+        }
+    }
+    std::sort(codes.begin(), codes.end());
+    return codes;
+}
+
+std::size_t KmerHashTable::countOccurrences(const std::string& kmer) const {
+    auto [lower, upper] = findInterval(kmer);
+    return upper - lower;
+}
+
+std::vector<std::size_t> KmerHashTable::findOccurrences(const std::string& kmer) const {
+    std::vector<std::size_t> occurrences;
+    auto [lower, upper] = findInterval(kmer);
+    occurrences.reserve(upper - lower);
+    for (std::size_t i = lower; i < upper; ++i) {
+        occurrences.push_back(positions[i]);
+    }
+    return occurrences;
+}
+
+void KmerHashTable::save(IndexFile::Writer& writer) const {
+    writer.addSection(IndexFile::PACKED_TEXT, sequence.wordData(),
+                      sequence.wordCount() * sizeof(std::uint64_t));
+    writer.addSection(IndexFile::N_RUNS, sequence.runData(),
+                      sequence.runSize() * sizeof(PackedSequence::NRun));
+    writer.addSection(IndexFile::KMER_HASH_HEADER, &header, sizeof(Header));
+    writer.addSection(IndexFile::KMER_HASH_BUCKETS, bucketStart.data(), bucketStart.sizeBytes());
+    writer.addSection(IndexFile::KMER_HASH_GROUPS, groups, header.groupCount * sizeof(Group));
+    writer.addSection(IndexFile::KMER_HASH_POSITIONS, positions.data(), positions.sizeBytes());
+}
+
+KmerHashTable KmerHashTable::load(const IndexFile::Reader& reader) {
+    KmerHashTable table;
+    table.mapping = reader.getMapping();
+
+    std::string_view textSection = reader.getSection(IndexFile::PACKED_TEXT);
+    std::string_view runSection = reader.getSection(IndexFile::N_RUNS);
+    std::string_view headerSection = reader.getSection(IndexFile::KMER_HASH_HEADER);
+    std::string_view bucketSection = reader.getSection(IndexFile::KMER_HASH_BUCKETS);
+    std::string_view groupSection = reader.getSection(IndexFile::KMER_HASH_GROUPS);
+    std::string_view positionSection = reader.getSection(IndexFile::KMER_HASH_POSITIONS);
+
+    if (headerSection.size() != sizeof(Header)) {
+        throw std::runtime_error("Erreur : En-tête de la table de k-mers incohérent");
+    }
+    std::memcpy(&table.header, headerSection.data(), sizeof(Header));
+    const Header& h = table.header;
+
+    // Largeurs des tables déduites de la taille des sections (4 octets pour une table vide)
+    auto widthOf = [](std::size_t bytes, std::size_t count) -> std::size_t {
+        return count == 0 ? 4 : bytes / count;
+    };
+    const std::size_t bases = reader.getMetadata().referenceLength;
+    const std::size_t bucketWidth = widthOf(bucketSection.size(), h.bucketCount + 1);
+    const std::size_t positionWidth = widthOf(positionSection.size(), h.positionCount);
+    auto validWidth = [](std::size_t w) { return w == 4 || w == 5 || w == 8; };
+    if (h.kmerSize == 0 || h.kmerSize > MAX_KMER_SIZE || h.stepSize == 0 ||
+        h.windowSize != reader.getMetadata().minimizerWindow ||
+        h.bucketCount == 0 || (h.bucketCount & (h.bucketCount - 1)) != 0 || h.groupCount == 0 ||
+        textSection.size() != (bases + PackedSequence::BASES_PER_WORD - 1) / PackedSequence::BASES_PER_WORD * sizeof(std::uint64_t) ||
+        runSection.size() % sizeof(PackedSequence::NRun) != 0 ||
+        !validWidth(bucketWidth) || bucketSection.size() != (h.bucketCount + 1) * bucketWidth ||
+        groupSection.size() != h.groupCount * sizeof(Group) ||
+        !validWidth(positionWidth) || positionSection.size() != h.positionCount * positionWidth) {
+        throw std::runtime_error("Erreur : Table de k-mers incohérente dans l'index");
+    }
+
+    // Les sections sont alignées sur 64 octets : lecture directe dans la projection
+    table.sequence = PackedSequence::view(
+        reinterpret_cast<const std::uint64_t*>(textSection.data()), bases,
+        reinterpret_cast<const PackedSequence::NRun*>(runSection.data()),
+        runSection.size() / sizeof(PackedSequence::NRun));
+    table.bucketStart = IndexArray::view(bucketSection.data(), h.bucketCount + 1,
+                                         static_cast<unsigned>(bucketWidth));
+    table.groups = reinterpret_cast<const Group*>(groupSection.data());
+    table.positions = IndexArray::view(positionSection.data(), h.positionCount,
+                                       static_cast<unsigned>(positionWidth));
+    return table;
+}
@@ -1,21 +1,148 @@
 #include "KmerIndex.h"
 #include <algorithm>
+#include <cstring>
 #include <numeric>
 #include <stdexcept>
 
-KmerIndex::KmerIndex(const std::string& referenceGenome, std::size_t k, std::size_t step)
-    : reference(referenceGenome), 
-      kmerSize(k),
+KmerIndex::KmerIndex(const std::string& referenceGenome, std::size_t k, std::size_t step,
+                     const IndexOptions& options)
+    : kmerSize(k),
       stepSize(step == 0 ? 1 : step), // step minimum à 1
-      suffixArray(referenceGenome) {
+      minimizerWindow(options.minimizerWindow),
+      engine(buildEngine(referenceGenome, k, stepSize, options)),
+      maskThreshold(options.maskThreshold) {
 
     if (kmerSize == 0) {
         throw std::invalid_argument("Taille de k-mer invalide");
     }
 
-    if (reference.length() < kmerSize) {
+    if (getReference().length() < kmerSize) {
         throw std::invalid_argument("Référence plus courte que kmerSize");
     }
+
+    // Les minimiseurs sont comparés sur des codes 64 bits
+    if (minimizerWindow > 0 && kmerSize > KmerHashTable::MAX_KMER_SIZE) {
+        throw std::invalid_argument("Mode minimiseurs limité à k ≤ 32");
+    }
+
+    // Le masque est consulté par code 2 bits, avant la recherche
+    if (maskThreshold > 0) {
+        if (kmerSize > KmerHashTable::MAX_KMER_SIZE) {
+            throw std::invalid_argument("Masquage des k-mers fréquents limité à k ≤ 32");
+        }
+        maskedKmers = findFrequentKmers(maskThreshold);
+    }
+}
+
+std::vector<std::uint64_t> KmerIndex::findFrequentKmers(std::size_t threshold) const {
+    std::vector<std::uint64_t> codes;
+    std::visit([&](const auto& e) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(e)>, KmerHashTable>) {
+            codes = e.frequentCodes(threshold);
+        } else {
+            // Parcours en profondeur des préfixes ACGT : allonger un motif ne peut que réduire
+            // son nombre d'occurrences, seules les branches au-dessus du seuil sont explorées.
+            // L'ordre A, C, G, T donne des codes croissants.
+            char bases[KmerHashTable::MAX_KMER_SIZE];
+            auto descend = [&](auto& self, std::size_t depth, std::uint64_t code) -> void {
+                if (depth == kmerSize) {
+                    codes.push_back(code);
+                    return;
+                }
+                for (unsigned c = 0; c < 4; ++c) {
+                    bases[depth] = "ACGT"[c];
+                    auto [lower, upper] = e.findInterval(std::string_view(bases, depth + 1));
+                    if (upper - lower > threshold) self(self, depth + 1, (code << 2) | c);
+                }
+            };
+            descend(descend, 0, 0);
+        }
+    }, engine);
+    return codes;
+}
+
+KmerIndex::Engine KmerIndex::buildEngine(const std::string& referenceGenome, std::size_t k,
+                                         std::size_t step, const IndexOptions& options) {
+    // La table de hachage se construit directement sur la référence compactée
+    if (options.engine == IndexEngine::HASH_TABLE) {
+        return KmerHashTable(PackedSequence(referenceGenome), k, step, options.minimizerWindow);
+    }
+
+    SuffixArray suffixArray(referenceGenome, options.buildMethod, options.numThreads);
+
+    // L'index FM se déduit de la table SA, qui est libérée ensuite
+    if (options.engine == IndexEngine::FM_INDEX) {
+        return FMIndex::fromSuffixArray(std::move(suffixArray), options.sampleRate);
+    }
+
+    unsigned q = options.prefixLength < 0
+        ? SuffixArray::defaultPrefixLength(suffixArray.getReferenceLength())
+        : static_cast<unsigned>(options.prefixLength);
+    suffixArray.buildPrefixTable(q);
+    return suffixArray;
+}
+
+KmerIndex::KmerIndex(Engine&& loadedEngine, std::size_t k, std::size_t step, std::size_t window,
+                     std::size_t threshold, std::vector<std::uint64_t>&& masked)
+    : kmerSize(k),
+      stepSize(step == 0 ? 1 : step),
+      minimizerWindow(window),
+      engine(std::move(loadedEngine)),
+      maskThreshold(threshold),
+      maskedKmers(std::move(masked)) {
+
+    if (kmerSize == 0 || getReference().length() < kmerSize ||
+        (maskThreshold > 0 && kmerSize > KmerHashTable::MAX_KMER_SIZE)) {
+        throw std::runtime_error("Erreur : Paramètres k-mer incohérents dans l'index");
+    }
+}
+
+void KmerIndex::save(const std::string& indexPath) const {
+    IndexFile::Writer writer;
+    std::visit([&writer](const auto& e) { e.save(writer); }, engine);
+    if (maskThreshold > 0) {
+        writer.addSection(IndexFile::MASKED_KMERS, maskedKmers.data(),
+                          maskedKmers.size() * sizeof(std::uint64_t));
+    }
+
+    IndexFile::Metadata metadata;
+    metadata.kmerSize = kmerSize;
+    metadata.stepSize = stepSize;
+    metadata.referenceLength = getReference().length();
+    metadata.minimizerWindow = minimizerWindow;
+    metadata.maskThreshold = maskThreshold;
+    writer.write(indexPath, metadata);
+}
+
+KmerIndex KmerIndex::load(const std::string& indexPath) {
+    IndexFile::Reader reader(indexPath);
+    const IndexFile::Metadata& metadata = reader.getMetadata();
+
+    // Liste des k-mers masqués : petite, copiée hors de la projection
+    std::vector<std::uint64_t> masked;
+    if (metadata.maskThreshold > 0) {
+        std::string_view section = reader.getSection(IndexFile::MASKED_KMERS);
+        if (section.size() % sizeof(std::uint64_t) != 0) {
+            throw std::runtime_error("Erreur : Liste des k-mers masqués incohérente dans l'index");
+        }
+        masked.resize(section.size() / sizeof(std::uint64_t));
+        if (!masked.empty()) std::memcpy(masked.data(), section.data(), section.size());
+        if (!std::is_sorted(masked.begin(), masked.end())) {
+            throw std::runtime_error("Erreur : Liste des k-mers masqués incohérente dans l'index");
+        }
+    }
+
+    // La structure de recherche se reconnaît à ses sections
+    if (reader.hasSection(IndexFile::FM_HEADER)) {
+        return KmerIndex(FMIndex::load(reader), metadata.kmerSize, metadata.stepSize,
+                         metadata.minimizerWindow, metadata.maskThreshold, std::move(masked));
+    }
+    if (reader.hasSection(IndexFile::KMER_HASH_HEADER)) {
+        return KmerIndex(KmerHashTable::load(reader), metadata.kmerSize, metadata.stepSize,
+                         metadata.minimizerWindow, metadata.maskThreshold, std::move(masked));
+    }
+    return KmerIndex(SuffixArray::load(reader), metadata.kmerSize, metadata.stepSize,
+                     metadata.minimizerWindow, metadata.maskThreshold, std::move(masked));
 }
 
 void KmerIndex::processSingleRead(const std::string& read,
@@ -65,5 +192,5 @@ std::vector<std::size_t> KmerIndex::findKmerPositions(const std::string& kmer) c
     if (kmer.length() != kmerSize) {
         throw std::invalid_argument("Taille de k-mer incorrecte");
     }
-    return suffixArray.findOccurrences(kmer);
+    return std::visit([&kmer](const auto& e) { return e.findOccurrences(kmer); }, engine);
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+MappedFile::MappedFile(const std::string& filePath) {
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Erreur : Impossible de lire la taille du fichier " + filePath);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+
+    // mmap refuse une longueur nulle : un fichier vide reste non projeté
+    if (length > 0) {
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Erreur : Projection mémoire impossible pour " + filePath);
+        }
+        data = static_cast<const char*>(address);
+    }
+    // Le descripteur n'est plus nécessaire une fois la projection établie
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+}
+
+void MappedFile::adviseSequential() const {
+    if (data != nullptr) {
+        ::madvise(const_cast<char*>(data), length, MADV_SEQUENTIAL);
+    }
+}
@@ -0,0 +1,263 @@
+#include "MappingPipeline.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+template <typename Records, typename Result>
+struct Batch {
+    std::size_t id = 0;
+    Records records;
+    std::vector<Result> results;
+    std::string text; // lignes formatées par le thread de calcul (runFormatted)
+};
+
+// Mapping d'un lot, par bloc de reads (tampons réutilisés d'un lot à l'autre, un par thread)
+std::vector<MappingResult> mapRecords(const ReadMapper& mapper, const std::vector<ReadRecord>& records) {
+    thread_local ReadBlock block;
+    block.clear();
+    for (const auto& record : records) {
+        block.add(record.sequence);
+    }
+    return mapper.mapBatch(block);
+}
+
+std::vector<PairedMappingResult> mapRecords(const ReadMapper& mapper, const std::vector<ReadPair>& pairs) {
+    thread_local ReadBlock mates1, mates2;
+    mates1.clear();
+    mates2.clear();
+    for (const auto& pair : pairs) {
+        mates1.add(pair.mate1.sequence);
+        mates2.add(pair.mate2.sequence);
+    }
+    return mapper.mapPairs(mates1, mates2);
+}
+
+// Lot en colonnes : ses séquences forment déjà un bloc, aucune copie
+std::vector<MappingResult> mapRecords(const ReadMapper& mapper, const std::unique_ptr<RecordBatch>& batch) {
+    return mapper.mapBatch(batch->getSequences());
+}
+
+template <typename Record>
+std::size_t recordCount(const std::vector<Record>& records) { return records.size(); }
+std::size_t recordCount(const std::unique_ptr<RecordBatch>& batch) { return batch ? batch->size() : 0; }
+
+// Levée dans le lecteur pour interrompre la source quand le pipeline s'arrête sur erreur
+struct PipelineStopped {};
+
+// État partagé, protégé par mutex
+template <typename Batch>
+struct PipelineState {
+    std::mutex mutex;
+    std::condition_variable slotFree;      // lecteur : une place s'est libérée
+    std::condition_variable workAvailable; // calcul : un lot attend ou la lecture est finie
+    std::condition_variable batchDone;     // écriture : un lot est mappé
+
+    std::deque<std::unique_ptr<Batch>> pending;      // lots lus, pas encore mappés
+    std::vector<std::unique_ptr<Batch>> done;        // lots mappés, rangés par id % capacité
+    std::size_t nextId = 0;      // prochain lot lu
+    std::size_t nextWrite = 0;   // prochain lot à écrire
+    bool readerFinished = false;
+    bool stopped = false;
+    std::exception_ptr error;
+
+    explicit PipelineState(std::size_t capacity) : done(capacity) {}
+
+    // Première erreur conservée ; réveille tous les threads pour qu'ils s'arrêtent
+    void fail(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = e;
+        stopped = true;
+        slotFree.notify_all();
+        workAvailable.notify_all();
+        batchDone.notify_all();
+    }
+};
+
+} // namespace
+
+MappingPipeline::MappingPipeline(const ReadMapper& mapper, unsigned numThreads, std::size_t batchSize,
+                                 std::size_t maxBatchesInFlight)
+    : mapper(mapper), numThreads(numThreads), batchSize(batchSize), maxBatchesInFlight(maxBatchesInFlight) {
+    if (this->numThreads == 0) {
+        this->numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (this->batchSize == 0) {
+        throw std::invalid_argument("La taille des lots doit être > 0");
+    }
+    if (this->maxBatchesInFlight == 0) {
+        this->maxBatchesInFlight = 4 * static_cast<std::size_t>(this->numThreads);
+    }
+}
+
+template <typename Record>
+std::function<void(const std::function<void(std::vector<Record>&&)>&)>
+MappingPipeline::groupIntoBatches(const std::function<void(const std::function<void(Record&&)>&)>& source) const {
+    const std::size_t size = batchSize;
+    return [&source, size](const std::function<void(std::vector<Record>&&)>& emit) {
+        std::vector<Record> records;
+        records.reserve(size);
+        source([&](Record&& record) {
+            records.push_back(std::move(record));
+            if (records.size() == size) {
+                emit(std::move(records));
+                records = std::vector<Record>();
+                records.reserve(size);
+            }
+        });
+        if (!records.empty()) emit(std::move(records));
+    };
+}
+
+std::size_t MappingPipeline::run(const RecordSource& source, const ResultSink& sink) const {
+    return runBatches<std::vector<ReadRecord>, MappingResult>(groupIntoBatches(source),
+        [](const auto&, const auto&, std::string&) {},
+        [&sink](const auto& records, const auto& results, const std::string&) {
+            for (std::size_t i = 0; i < records.size(); ++i) sink(records[i], results[i]);
+        });
+}
+
+std::size_t MappingPipeline::runPaired(const PairSource& source, const PairSink& sink) const {
+    return runBatches<std::vector<ReadPair>, PairedMappingResult>(groupIntoBatches(source),
+        [](const auto&, const auto&, std::string&) {},
+        [&sink](const auto& pairs, const auto& results, const std::string&) {
+            for (std::size_t i = 0; i < pairs.size(); ++i) sink(pairs[i], results[i]);
+        });
+}
+
+std::size_t MappingPipeline::runFormatted(const RecordSource& source, const RecordFormatter& format,
+                                          const BlockSink& write) const {
+    return runBatches<std::vector<ReadRecord>, MappingResult>(groupIntoBatches(source),
+        [&format](const auto& records, const auto& results, std::string& text) {
+            for (std::size_t i = 0; i < records.size(); ++i) format(records[i], results[i], text);
+        },
+        [&write](const auto&, const auto&, const std::string& text) { write(text); });
+}
+
+std::size_t MappingPipeline::runPairedFormatted(const PairSource& source, const PairFormatter& format,
+                                                const BlockSink& write) const {
+    return runBatches<std::vector<ReadPair>, PairedMappingResult>(groupIntoBatches(source),
+        [&format](const auto& pairs, const auto& results, std::string& text) {
+            for (std::size_t i = 0; i < pairs.size(); ++i) format(pairs[i], results[i], text);
+        },
+        [&write](const auto&, const auto&, const std::string& text) { write(text); });
+}
+
+std::size_t MappingPipeline::runRecordBatches(const BatchSource& source, RecordBatchPool& pool,
+                                             const BatchSink& sink) const {
+    return runBatches<std::unique_ptr<RecordBatch>, MappingResult>(source,
+        [](const auto&, const auto&, std::string&) {},
+        [&sink, &pool](auto& batch, const auto& results, const std::string&) {
+            sink(*batch, results);
+            pool.release(std::move(batch));
+        });
+}
+
+std::size_t MappingPipeline::runRecordBatchesFormatted(const BatchSource& source, RecordBatchPool& pool,
+                                                      const BatchFormatter& format, const BlockSink& write) const {
+    return runBatches<std::unique_ptr<RecordBatch>, MappingResult>(source,
+        [&format](const auto& batch, const auto& results, std::string& text) { format(*batch, results, text); },
+        [&write, &pool](auto& batch, const auto&, const std::string& text) {
+            write(text);
+            pool.release(std::move(batch));
+        });
+}
+
+template <typename Records, typename Result, typename Format, typename Emit>
+std::size_t MappingPipeline::runBatches(const std::function<void(const std::function<void(Records&&)>&)>& source,
+                                        Format&& format, Emit&& emit) const {
+    using Batch = ::Batch<Records, Result>;
+    PipelineState<Batch> state(maxBatchesInFlight);
+    const std::size_t capacity = maxBatchesInFlight;
+
+    // Lecteur : reçoit les lots de la source et attend une place libre avant d'en soumettre un
+    auto submit = [&](std::unique_ptr<Batch>& batch) {
+        std::unique_lock<std::mutex> lock(state.mutex);
+        state.slotFree.wait(lock, [&] { return state.stopped || state.nextId - state.nextWrite < capacity; });
+        if (state.stopped) throw PipelineStopped{};
+        batch->id = state.nextId++;
+        state.pending.push_back(std::move(batch));
+        state.workAvailable.notify_one();
+    };
+    std::thread reader([&] {
+        try {
+            source([&](Records&& records) {
+                if (recordCount(records) == 0) return;
+                auto batch = std::make_unique<Batch>();
+                batch->records = std::move(records);
+                submit(batch);
+            });
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.readerFinished = true;
+            state.workAvailable.notify_all();
+            state.batchDone.notify_all();
+        } catch (const PipelineStopped&) {
+        } catch (...) {
+            state.fail(std::current_exception());
+        }
+    });
+
+    // Calcul : un lot entier par prise du verrou
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&] {
+            try {
+                for (;;) {
+                    std::unique_ptr<Batch> batch;
+                    {
+                        std::unique_lock<std::mutex> lock(state.mutex);
+                        state.workAvailable.wait(lock, [&] {
+                            return state.stopped || !state.pending.empty() || state.readerFinished;
+                        });
+                        if (state.stopped || state.pending.empty()) return;
+                        batch = std::move(state.pending.front());
+                        state.pending.pop_front();
+                    }
+                    batch->results = mapRecords(mapper, batch->records);
+                    format(batch->records, batch->results, batch->text);
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.done[batch->id % capacity] = std::move(batch);
+                    state.batchDone.notify_one();
+                }
+            } catch (...) {
+                state.fail(std::current_exception());
+            }
+        });
+    }
+
+    // Écriture dans l'ordre d'entrée, depuis le thread appelant
+    std::size_t written = 0;
+    try {
+        for (;;) {
+            std::unique_ptr<Batch> batch;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                state.batchDone.wait(lock, [&] {
+                    return state.stopped || state.done[state.nextWrite % capacity] ||
+                           (state.readerFinished && state.nextWrite == state.nextId);
+                });
+                if (state.stopped) break;
+                batch = std::move(state.done[state.nextWrite % capacity]);
+                if (!batch) break; // lecture terminée, tout est écrit
+            }
+            emit(batch->records, batch->results, batch->text);
+            written += batch->results.size();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            ++state.nextWrite;
+            state.slotFree.notify_one();
+        }
+    } catch (...) {
+        state.fail(std::current_exception());
+    }
+
+    reader.join();
+    for (auto& worker : workers) worker.join();
+    if (state.error) std::rethrow_exception(state.error);
+    return written;
+}
@@ -0,0 +1,19 @@
+#include "MyersEditDistance.h"
+
+MyersEditDistance::MyersEditDistance(std::string_view pattern)
+    : patternLength(pattern.length()),
+      blockCount((pattern.length() + WORD_BITS - 1) / WORD_BITS),
+      peq(blockCount * ALPHABET, 0) {
+    // Bit i % 64 du mot du bloc i / 64 pour la base du motif en i ; les bases ambiguës
+    // (code 4) et les lignes au-delà du motif ne correspondent à aucune base du texte
+    for (std::size_t i = 0; i < patternLength; ++i) {
+        const unsigned c = KmerHashTable::baseCode(pattern[i]);
+        if (c < 4) {
+            peq[(i / WORD_BITS) * ALPHABET + c] |= std::uint64_t(1) << (i % WORD_BITS);
+        }
+    }
+}
+
+int MyersEditDistance::search(std::string_view text, int maxDistance) const {
+    return search(text.length(), [text](std::size_t j) { return KmerHashTable::baseCode(text[j]); }, maxDistance);
+}
@@ -0,0 +1,95 @@
+#include "PackedSequence.h"
+#include <algorithm>
+#include <array>
+
+// Code 2 bits de chaque caractère ; 4 pour tout ce qui n'est pas A/C/G/T
+static constexpr auto buildCodeTable = []() {
+    std::array<unsigned char, 256> table{};
+    table.fill(4);
+    table['A'] = 0; table['C'] = 1; table['G'] = 2; table['T'] = 3;
+    table['a'] = 0; table['c'] = 1; table['g'] = 2; table['t'] = 3;
+    return table;
+};
+static constexpr auto codeTable = buildCodeTable();
+
+PackedSequence::PackedSequence(std::string_view sequence) : baseCount(sequence.length()) {
+    wordStorage.assign(wordCount(), 0);
+
+    for (std::size_t i = 0; i < baseCount; ++i) {
+        unsigned c = codeTable[static_cast<unsigned char>(sequence[i])];
+        if (c == 4) {
+            // Base non-ACGT : prolonger l'intervalle courant ou en ouvrir un nouveau
+            if (!runStorage.empty() && runStorage.back().end == i) {
+                runStorage.back().end = i + 1;
+            } else {
+                runStorage.push_back({i, i + 1});
+            }
+            continue; // code 0 dans le mot, masqué par la table des N
+        }
+        wordStorage[i / BASES_PER_WORD] |= static_cast<std::uint64_t>(c) << (2 * (i % BASES_PER_WORD));
+    }
+
+    words = wordStorage.data();
+    nRuns = runStorage.data();
+    runCount = runStorage.size();
+    buildNBlocks();
+}
+
+PackedSequence PackedSequence::view(const std::uint64_t* wordData, std::size_t n,
+                                    const NRun* runData, std::size_t runN) {
+    PackedSequence sequence;
+    sequence.words = wordData;
+    sequence.baseCount = n;
+    sequence.nRuns = runData;
+    sequence.runCount = runN;
+    // Le filtre par bloc est petit (n / 2048 octets) : il est recalculé au chargement
+    sequence.buildNBlocks();
+    return sequence;
+}
+
+void PackedSequence::buildNBlocks() {
+    const std::size_t blocks = (baseCount >> N_BLOCK_SHIFT) + 1;
+    nBlocks.assign((blocks + 63) / 64, 0);
+    for (std::size_t r = 0; r < runCount; ++r) {
+        std::size_t first = nRuns[r].start >> N_BLOCK_SHIFT;
+        std::size_t last = (nRuns[r].end - 1) >> N_BLOCK_SHIFT;
+        for (std::size_t b = first; b <= last; ++b) {
+            nBlocks[b >> 6] |= std::uint64_t(1) << (b & 63);
+        }
+    }
+}
+
+bool PackedSequence::lookupN(std::size_t i) const {
+    // Premier intervalle dont la fin dépasse i
+    const NRun* end = nRuns + runCount;
+    const NRun* it = std::upper_bound(nRuns, end, i,
+        [](std::size_t position, const NRun& run) { return position < run.end; });
+    return it != end && it->start <= i;
+}
+
+bool PackedSequence::hasNInRange(std::size_t pos, std::size_t len) const {
+    if (runCount == 0 || len == 0) return false;
+    // Filtre par bloc : la plupart des fenêtres tombent dans des blocs sans N
+    std::size_t first = pos >> N_BLOCK_SHIFT;
+    std::size_t last = (pos + len - 1) >> N_BLOCK_SHIFT;
+    bool flagged = false;
+    for (std::size_t b = first; b <= last && !flagged; ++b) {
+        flagged = (nBlocks[b >> 6] >> (b & 63)) & 1u;
+    }
+    if (!flagged) return false;
+
+    const NRun* end = nRuns + runCount;
+    const NRun* it = std::upper_bound(nRuns, end, pos,
+        [](std::size_t position, const NRun& run) { return position < run.end; });
+    return it != end && it->start < pos + len;
+}
+
+std::string PackedSequence::extract(std::size_t pos, std::size_t len) const {
+    if (pos >= baseCount) return std::string();
+    len = std::min(len, baseCount - pos);
+    std::string bases(len, 'N');
+    for (std::size_t i = 0; i < len; ++i) {
+        bases[i] = (*this)[pos + i];
+    }
+    return bases;
+}
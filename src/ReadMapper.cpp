@@ -1,125 +1,548 @@
 #include "ReadMapper.h"
+#include "MinimizerSketch.h"
+#include "KmerEncoder.h"
+#include "ReverseComplement.h"
+#include "MyersEditDistance.h"
 #include <algorithm>
+#include <numeric>
+#include <optional>
 #include <cmath>
 #include <unordered_set>
+#include <string_view>
+#include <cstdint>
 #include <stdexcept>
 
-ReadMapper::ReadMapper(const std::string& referenceGenome, std::size_t kmerSize, std::size_t stepSize)
-    : kmerIndex(referenceGenome, kmerSize, stepSize), 
+ReadMapper::ReadMapper(const std::string& referenceGenome, std::size_t kmerSize, std::size_t stepSize,
+                       const IndexOptions& options)
+    : kmerIndex(referenceGenome, kmerSize, stepSize, options), 
       kmerSize(kmerSize), 
-      stepSize(stepSize) {}
+      stepSize(stepSize),
+      chainer(kmerSize) {}
+
+ReadMapper::ReadMapper(KmerIndex&& index)
+    : kmerIndex(std::move(index)),
+      kmerSize(kmerIndex.getKmerSize()),
+      stepSize(kmerIndex.getStepSize()),
+      chainer(kmerSize) {}
 
 MappingResult ReadMapper::mapRead(const std::string& read) const {
-    MappingResult result;
-    
     if (read.length() < kmerSize) {
-        return result;
+        return MappingResult{};
     }
 
-    auto candidates = findCandidatePositions(read);
-    if (candidates.empty()) return result;
+    // Une ancre par occurrence de k-mer. Le tampon est réutilisé d'un read à l'autre
+    // (un par thread) et les k-mers sont des codes 2 bits : aucune allocation par graine.
+    thread_local std::vector<Anchor> anchors;
+    anchors.clear();
+    collectAnchors(read, anchors);
+    return resultFromHits(read, hitsOf(read, anchors));
+}
 
-    std::vector<double> scores;
-    for (const auto& candidate : candidates) {
-        double score = evaluatePosition(read, candidate.first, candidate.second);
-        scores.push_back(score > 0 ? score : 0);
+std::vector<MappingResult> ReadMapper::mapBatch(const ReadBlock& block) const {
+    std::vector<MappingResult> results(block.size());
+    if (kmerSize > KmerHashTable::MAX_KMER_SIZE) {
+        // Pas de code 2 bits : chaque read est mappé seul
+        for (std::size_t r = 0; r < block.size(); ++r) {
+            results[r] = mapRead(std::string(block.read(r)));
+        }
+        return results;
     }
 
-    auto best_it = std::max_element(scores.begin(), scores.end());
-    std::size_t best_idx = static_cast<std::size_t>(std::distance(scores.begin(), best_it));
-    
-    result.referencePos = candidates[best_idx].first;
-    result.strand = candidates[best_idx].second;
-    result.confidence = scores[best_idx];
-    result.isUnique = (std::count(scores.begin(), scores.end(), *best_it) == 1);
-    
-    result.cigarString = generateCigar(read, result.referencePos, result.strand);
-    result.editDistance = calculateEditDistance(
-        read,
-        kmerIndex.getReference().substr(result.referencePos, read.length())
-    );
-    
-    return result;
+    std::vector<Anchor> anchors;
+    std::vector<std::size_t> begin;
+    collectBatchAnchors(block, anchors, begin);
+
+    std::vector<Anchor> readAnchors;
+    for (std::size_t r = 0; r < block.size(); ++r) {
+        std::string_view read = block.read(r);
+        if (read.length() < kmerSize) continue;
+        readAnchors.assign(anchors.begin() + begin[r], anchors.begin() + begin[r + 1]);
+        results[r] = resultFromHits(read, hitsOf(read, readAnchors));
+    }
+    return results;
 }
 
-std::vector<std::pair<std::size_t, Strand>> ReadMapper::findCandidatePositions(const std::string& read) const {
-    std::unordered_map<std::size_t, std::pair<int, int>> position_counts;
-    
-    // Forward strand
-    for (std::size_t i = 0; i <= read.length() - kmerSize; i += stepSize) {
-        std::string kmer = read.substr(i, kmerSize);
-        for (std::size_t pos : kmerIndex.findKmerPositions(kmer)) {
-            if (pos >= i) {
-                position_counts[pos - i].first++;
+void ReadMapper::collectBatchAnchors(const ReadBlock& block, std::vector<Anchor>& byRead,
+                                     std::vector<std::size_t>& begin) const {
+    // Toutes les graines du lot, triées par code : les recherches parcourent la table
+    // des suffixes dans l'ordre lexicographique et un k-mer répété (dans un read ou
+    // d'un read à l'autre) n'est recherché qu'une fois
+    struct SeedQuery {
+        std::uint64_t code;
+        std::uint32_t read;
+        std::uint32_t offset; // position du k-mer dans le brin interrogé
+        std::uint64_t reverse;
+    };
+    std::vector<SeedQuery> queries;
+    for (std::size_t r = 0; r < block.size(); ++r) {
+        std::string_view read = block.read(r);
+        if (read.length() < kmerSize) continue;
+        forEachSeed(read, [&](std::uint64_t code, std::size_t i, std::uint64_t reverse) {
+            queries.push_back({code, static_cast<std::uint32_t>(r), static_cast<std::uint32_t>(i), reverse});
+        });
+    }
+    std::sort(queries.begin(), queries.end(),
+              [](const SeedQuery& a, const SeedQuery& b) { return a.code < b.code; });
+
+    // Ancres de tous les reads (owners : read de chaque ancre), regroupées ensuite par read
+    std::vector<Anchor> anchors;
+    std::vector<std::uint32_t> owners;
+    std::vector<std::size_t> positions;
+    for (std::size_t q = 0; q < queries.size(); ) {
+        const std::uint64_t code = queries[q].code;
+        positions.clear();
+        kmerIndex.forEachKmerPosition(code, [&positions](std::size_t pos) { positions.push_back(pos); },
+                                      maxOccurrences);
+        for (; q < queries.size() && queries[q].code == code; ++q) {
+            const SeedQuery& query = queries[q];
+            for (std::size_t pos : positions) {
+                if (pos >= query.offset) {
+                    anchors.push_back({pos - query.offset, query.offset, static_cast<std::uint32_t>(query.reverse)});
+                    owners.push_back(query.read);
+                }
             }
         }
     }
-    
-    // Reverse complement
-    std::string rc = getReverseComplement(read);
-    for (std::size_t i = 0; i <= rc.length() - kmerSize; i += stepSize) {
-        std::string kmer = rc.substr(i, kmerSize);
-        for (std::size_t pos : kmerIndex.findKmerPositions(kmer)) {
+
+    // Tri par comptage sur le read : les ancres du read r occupent [begin[r], begin[r + 1])
+    begin.assign(block.size() + 1, 0);
+    for (std::uint32_t owner : owners) ++begin[owner + 1];
+    std::partial_sum(begin.begin(), begin.end(), begin.begin());
+    byRead.resize(anchors.size());
+    std::vector<std::size_t> next(begin.begin(), begin.end() - 1);
+    for (std::size_t a = 0; a < anchors.size(); ++a) {
+        byRead[next[owners[a]]++] = anchors[a];
+    }
+}
+
+template <typename Callback>
+void ReadMapper::forEachSeed(std::string_view read, Callback&& callback) const {
+    // Avec la table de hachage, le pas est appliqué à la référence : on interroge tous les k-mers
+    const std::size_t queryStep = kmerIndex.getQueryStep();
+    const std::size_t len = read.length();
+
+    if (kmerIndex.getMinimizerWindow() > 0) {
+        // Mode minimiseurs : seuls les minimiseurs de chaque brin du read sont interrogés ;
+        // le brin reverse est lu à l'envers et complémenté à la volée
+        MinimizerSketch sketch(kmerSize, kmerIndex.getMinimizerWindow());
+        sketch.forEach(len,
+            [read](std::size_t i) { return KmerHashTable::baseCode(read[i]); },
+            [&](std::size_t i, std::uint64_t code) { callback(code, i, 0); });
+        sketch.forEach(len,
+            [read, len](std::size_t i) {
+                unsigned base = KmerHashTable::baseCode(read[len - 1 - i]);
+                return base > 3 ? base : 3 - base;
+            },
+            [&](std::size_t i, std::uint64_t code) { callback(code, i, 1); });
+    } else {
+        // Une passe de codage glissant donne les deux brins : le complément inverse du
+        // k-mer en i est le k-mer en len - k - i du brin reverse
+        KmerEncoder(kmerSize).forEach(read, [&](std::size_t i, std::uint64_t forward, std::uint64_t reverse) {
+            if (i % queryStep == 0) {
+                callback(forward, i, 0);
+            }
+            const std::size_t j = len - kmerSize - i;
+            if (j % queryStep == 0) {
+                callback(reverse, j, 1);
+            }
+        });
+    }
+}
+
+void ReadMapper::collectAnchors(const std::string& read, std::vector<Anchor>& anchors) const {
+    // Diagonale pos - i (i : position du k-mer dans le brin du read interrogé)
+    auto record = [&anchors](std::size_t i, std::uint64_t reverse) {
+        return [&anchors, i, reverse](std::size_t pos) {
             if (pos >= i) {
-                position_counts[pos - i].second++;
+                anchors.push_back({pos - i, static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(reverse)});
             }
+        };
+    };
+
+    if (kmerSize > KmerHashTable::MAX_KMER_SIZE) {
+        // k > 32 : pas de code 2 bits, les k-mers sont des vues sur chaque brin du read
+        const std::size_t queryStep = kmerIndex.getQueryStep();
+        const std::string rc = getReverseComplement(read);
+        for (std::size_t i = 0; i <= read.length() - kmerSize; i += queryStep) {
+            kmerIndex.forEachKmerPosition(std::string_view(read).substr(i, kmerSize), record(i, 0), maxOccurrences);
+            kmerIndex.forEachKmerPosition(std::string_view(rc).substr(i, kmerSize), record(i, 1), maxOccurrences);
         }
+        return;
     }
-    
+    forEachSeed(read, [&](std::uint64_t code, std::size_t i, std::uint64_t reverse) {
+        kmerIndex.forEachKmerPosition(code, record(i, reverse), maxOccurrences);
+    });
+}
+
+std::vector<std::pair<std::size_t, Strand>> ReadMapper::rankCandidates(std::vector<Anchor>& anchors) const {
+    // Une chaîne par groupe d'ancres : un indel ne disperse plus les graines du read
+    // sur plusieurs candidats, et les candidats arrivent classés par score de chaîne
     std::vector<std::pair<std::size_t, Strand>> candidates;
-    for (const auto& entry : position_counts) {
-        if (entry.second.first > 0 || entry.second.second > 0) {
-            Strand strand = (entry.second.first >= entry.second.second) ? 
-                          Strand::FORWARD : Strand::REVERSE_COMPLEMENT;
-            candidates.emplace_back(entry.first, strand);
-        }
+    for (const Chain& chain : chainer.chain(anchors)) {
+        candidates.emplace_back(chain.diagonal, chain.reverse ? Strand::REVERSE_COMPLEMENT : Strand::FORWARD);
     }
-    
     return candidates;
 }
 
-double ReadMapper::evaluatePosition(const std::string& read, std::size_t pos, Strand strand) const {
-    const std::string& reference = kmerIndex.getReference();
+std::vector<std::pair<std::size_t, Strand>> ReadMapper::filterCandidates(
+        std::string_view read, std::string_view rc, std::vector<std::pair<std::size_t, Strand>> candidates) const {
+    if (maxEditDistance < 0 || candidates.empty()) return candidates;
+
+    // Un alignement à au plus maxEditDistance éditions commence à moins de maxEditDistance
+    // bases de la diagonale d'une de ses graines : fenêtre [pos - d, pos + len + d)
+    const PackedSequence& reference = kmerIndex.getReference();
+    const std::size_t margin = static_cast<std::size_t>(maxEditDistance);
+    std::optional<MyersEditDistance> forward, reverse; // motifs construits à la demande
+    auto plausible = [&](const std::pair<std::size_t, Strand>& candidate) {
+        std::optional<MyersEditDistance>& pattern = candidate.second == Strand::FORWARD ? forward : reverse;
+        if (!pattern) {
+            pattern.emplace(candidate.second == Strand::FORWARD ? read : rc);
+        }
+        const std::size_t start = candidate.first > margin ? candidate.first - margin : 0;
+        const std::size_t end = std::min(reference.length(), candidate.first + read.length() + margin);
+        const int distance = pattern->search(end > start ? end - start : 0, [&](std::size_t j) {
+            return reference.isN(start + j) ? 4u : reference.code(start + j);
+        }, maxEditDistance);
+        return distance <= maxEditDistance;
+    };
+    std::erase_if(candidates, [&](const auto& candidate) { return !plausible(candidate); });
+    return candidates;
+}
+
+std::vector<ReadMapper::Hit> ReadMapper::hitsOf(std::string_view read, std::vector<Anchor>& anchors) const {
+    std::vector<std::pair<std::size_t, Strand>> candidates = rankCandidates(anchors);
+    // Brin reverse du read calculé une fois (seulement s'il a un candidat), partagé par le
+    // filtre et la vérification
+    const bool reverse = std::any_of(candidates.begin(), candidates.end(),
+        [](const auto& candidate) { return candidate.second == Strand::REVERSE_COMPLEMENT; });
+    const std::string rc = reverse ? getReverseComplement(std::string(read)) : std::string();
+    return verifyCandidates(read, rc, filterCandidates(read, rc, std::move(candidates)));
+}
+
+std::vector<ReadMapper::Hit> ReadMapper::verifyCandidates(std::string_view read, std::string_view rc,
+                                                          const std::vector<std::pair<std::size_t, Strand>>& candidates) const {
+    // Vérification : les meilleurs candidats (score de chaîne décroissant) sont alignés
+    // base par base ; un read trop long pour l'aligneur reste non mappé
+    const std::size_t verified = aligner.canAlign(read.length())
+        ? std::min(candidates.size(), MAX_VERIFIED_CANDIDATES) : 0;
+    std::vector<Hit> hits;
+    hits.reserve(verified);
+
+    for (std::size_t idx = 0; idx < verified; ++idx) {
+        const auto [pos, strand] = candidates[idx];
+        hits.push_back({alignCandidate(strand == Strand::FORWARD ? read : rc, pos), pos, strand});
+    }
+    return hits;
+}
+
+std::size_t ReadMapper::bestHitIndex(const std::vector<Hit>& hits, bool& unique) {
+    // Le meilleur score d'alignement l'emporte, le premier candidat à égalité ;
+    // unique s'il n'y a qu'un placement distinct à ce score
+    std::size_t bestIdx = 0;
+    std::vector<std::pair<std::size_t, Strand>> bestPlacements;
+    for (std::size_t idx = 0; idx < hits.size(); ++idx) {
+        const std::pair<std::size_t, Strand> placement(hits[idx].alignment.targetStart, hits[idx].strand);
+        if (idx == 0 || hits[idx].alignment.score > hits[bestIdx].alignment.score) {
+            bestIdx = idx;
+            bestPlacements.assign(1, placement);
+        } else if (hits[idx].alignment.score == hits[bestIdx].alignment.score &&
+                   std::find(bestPlacements.begin(), bestPlacements.end(), placement) == bestPlacements.end()) {
+            bestPlacements.push_back(placement);
+        }
+    }
+    unique = bestPlacements.size() == 1;
+    return bestIdx;
+}
+
+MappingResult ReadMapper::resultFromHits(std::string_view read, const std::vector<Hit>& hits) const {
+    if (hits.empty()) return MappingResult{};
+    bool unique = false;
+    const std::size_t best = bestHitIndex(hits, unique);
+    return resultFromHit(read, hits[best], unique);
+}
+
+MappingResult ReadMapper::resultFromHit(std::string_view read, const Hit& hit, bool unique) const {
+    MappingResult result{};
+    result.referencePos = hit.alignment.targetStart;
+    result.strand = hit.strand;
+    result.confidence = std::max(0.0, evaluatePosition(read, hit.diagonal, hit.strand));
+    result.isUnique = unique;
+    result.cigarString = hit.alignment.cigar;
+    result.editDistance = hit.alignment.editDistance;
+    result.alignmentScore = hit.alignment.score;
+    return result;
+}
+
+PairedMappingResult ReadMapper::mapPair(const std::string& read1, const std::string& read2) const {
+    ReadBlock mates1, mates2;
+    mates1.add(read1);
+    mates2.add(read2);
+    return mapPairs(mates1, mates2).front();
+}
+
+std::vector<PairedMappingResult> ReadMapper::mapPairs(const ReadBlock& mates1, const ReadBlock& mates2) const {
+    if (mates1.size() != mates2.size()) {
+        throw std::invalid_argument("Erreur : Les deux blocs de mates n'ont pas le même nombre de reads");
+    }
+    const std::size_t n = mates1.size();
+
+    // Les deux mates de toutes les paires sont cherchés ensemble : R1 en [0, n), R2 en [n, 2n)
+    ReadBlock both;
+    for (std::size_t r = 0; r < n; ++r) both.add(mates1.read(r));
+    for (std::size_t r = 0; r < n; ++r) both.add(mates2.read(r));
+
+    std::vector<std::vector<Hit>> hits(2 * n);
+    std::vector<Anchor> anchors;
+    if (kmerSize > KmerHashTable::MAX_KMER_SIZE) {
+        for (std::size_t r = 0; r < both.size(); ++r) {
+            std::string_view read = both.read(r);
+            if (read.length() < kmerSize) continue;
+            anchors.clear();
+            collectAnchors(std::string(read), anchors);
+            hits[r] = hitsOf(read, anchors);
+        }
+    } else {
+        std::vector<std::size_t> begin;
+        collectBatchAnchors(both, anchors, begin);
+        std::vector<Anchor> readAnchors;
+        for (std::size_t r = 0; r < both.size(); ++r) {
+            std::string_view read = both.read(r);
+            if (read.length() < kmerSize) continue;
+            readAnchors.assign(anchors.begin() + begin[r], anchors.begin() + begin[r + 1]);
+            hits[r] = hitsOf(read, readAnchors);
+        }
+    }
+
+    // Distribution des tailles d'insert du lot : paires dont les deux mates sont placés
+    // sans ambiguïté, face à face
+    std::vector<std::size_t> lengths;
+    for (std::size_t r = 0; r < n; ++r) {
+        if (hits[r].empty() || hits[n + r].empty()) continue;
+        bool unique1 = false, unique2 = false;
+        const Hit& best1 = hits[r][bestHitIndex(hits[r], unique1)];
+        const Hit& best2 = hits[n + r][bestHitIndex(hits[n + r], unique2)];
+        if (!unique1 || !unique2) continue;
+        if (const auto length = fragmentLength(best1, best2)) lengths.push_back(*length);
+    }
+    const InsertSizeDistribution insert = estimateInsertSize(std::move(lengths), insertSizePrior);
+
+    std::vector<PairedMappingResult> results(n);
+    for (std::size_t r = 0; r < n; ++r) {
+        results[r] = pairMates(mates1.read(r), mates2.read(r), hits[r], hits[n + r], insert);
+    }
+    return results;
+}
+
+InsertSizeDistribution ReadMapper::estimateInsertSize(std::vector<std::size_t> lengths,
+                                                      const InsertSizeDistribution& prior) {
+    if (lengths.size() < MIN_INSERT_SAMPLES) return prior;
+
+    // Comme BWA-MEM : les tailles hors de [Q1 - 2 IQR, Q3 + 2 IQR] (chimères, paires
+    // mal placées) sont écartées avant de calculer moyenne et écart-type
+    std::sort(lengths.begin(), lengths.end());
+    const double q1 = static_cast<double>(lengths[lengths.size() / 4]);
+    const double q3 = static_cast<double>(lengths[lengths.size() * 3 / 4]);
+    const double low = q1 - 2.0 * (q3 - q1);
+    const double high = q3 + 2.0 * (q3 - q1);
+
+    double sum = 0.0, sumSquares = 0.0;
+    std::size_t kept = 0;
+    for (std::size_t length : lengths) {
+        const double x = static_cast<double>(length);
+        if (x < low || x > high) continue;
+        sum += x;
+        sumSquares += x * x;
+        ++kept;
+    }
+    if (kept < MIN_INSERT_SAMPLES) return prior;
+
+    InsertSizeDistribution estimate;
+    estimate.mean = sum / static_cast<double>(kept);
+    estimate.stdDev = std::max(1.0, std::sqrt(std::max(0.0, sumSquares / static_cast<double>(kept) -
+                                                            estimate.mean * estimate.mean)));
+    estimate.samples = kept;
+    return estimate;
+}
+
+std::optional<std::size_t> ReadMapper::fragmentLength(const Hit& a, const Hit& b) {
+    // Orientation FR : le mate forward commence le fragment, le mate reverse le termine
+    if (a.strand == b.strand) return std::nullopt;
+    const Hit& forward = a.strand == Strand::FORWARD ? a : b;
+    const Hit& reverse = a.strand == Strand::FORWARD ? b : a;
+    if (reverse.alignment.targetEnd <= forward.alignment.targetStart) return std::nullopt;
+    return reverse.alignment.targetEnd - forward.alignment.targetStart;
+}
+
+bool ReadMapper::isProperPair(const Hit& a, const Hit& b, const InsertSizeDistribution& insert) {
+    const auto length = fragmentLength(a, b);
+    return length && std::abs(static_cast<double>(*length) - insert.mean) <= PROPER_PAIR_STD_DEVS * insert.stdDev;
+}
+
+std::optional<ReadMapper::Hit> ReadMapper::rescueMate(std::string_view mate, const Hit& partner,
+                                                      const InsertSizeDistribution& insert) const {
+    // Le mate est attendu sur l'autre brin, à une taille d'insert moyenne du partenaire :
+    // il est aligné dans une bande de ±PROPER_PAIR_STD_DEVS écarts-types autour de cette
+    // position, sans recherche de graines. La bande est bornée à MAX_RESCUE_BAND : la trace
+    // et la programmation dynamique croissent avec son carré, et l'espace de travail de
+    // l'aligneur garde la mémoire d'un sauvetage à l'autre
+    const PackedSequence& reference = kmerIndex.getReference();
+    const Strand strand = partner.strand == Strand::FORWARD ? Strand::REVERSE_COMPLEMENT : Strand::FORWARD;
+    const long length = static_cast<long>(mate.length());
+    const long mean = std::lround(insert.mean);
+    const long expectedStart = partner.strand == Strand::FORWARD
+        ? static_cast<long>(partner.alignment.targetStart) + mean - length
+        : static_cast<long>(partner.alignment.targetEnd) - mean;
+    const long band = std::max(static_cast<long>(aligner.getBandWidth()),
+                               std::min(static_cast<long>(MAX_RESCUE_BAND),
+                                        std::lround(std::ceil(PROPER_PAIR_STD_DEVS * insert.stdDev))));
+    const long windowStart = std::max(0L, expectedStart - band);
+    const long windowEnd = std::min(static_cast<long>(reference.length()), expectedStart + length + band);
+    // Un mate plus court que k ou trop long pour l'aligneur n'est jamais mappé seul (mapRead) :
+    // il n'est pas repêché non plus
+    if (mate.length() < kmerIndex.getKmerSize() || !aligner.canAlign(mate.length()) ||
+        windowStart >= windowEnd) return std::nullopt;
+
+    const std::string rc = strand == Strand::FORWARD ? std::string() : getReverseComplement(std::string(mate));
+    const BandedAligner rescuer(aligner.getScoring(), static_cast<std::size_t>(band));
+    BandedAligner::Alignment alignment = rescuer.align(
+        strand == Strand::FORWARD ? mate : std::string_view(rc),
+        reference.extract(static_cast<std::size_t>(windowStart), static_cast<std::size_t>(windowEnd - windowStart)),
+        expectedStart - windowStart);
+    // Au moins la moitié du read doit s'aligner : un alignement local dans une fenêtre
+    // de quelques centaines de bases n'atteint pas ce score par hasard
+    if (2 * alignment.score < length * aligner.getScoring().match) return std::nullopt;
+
+    alignment.targetStart += static_cast<std::size_t>(windowStart);
+    alignment.targetEnd += static_cast<std::size_t>(windowStart);
+    const std::size_t diagonal = alignment.targetStart > alignment.queryStart
+        ? alignment.targetStart - alignment.queryStart : 0;
+    Hit hit{std::move(alignment), diagonal, strand};
+    if (!isProperPair(partner, hit, insert)) return std::nullopt;
+    return hit;
+}
+
+PairedMappingResult ReadMapper::pairMates(std::string_view read1, std::string_view read2,
+                                          const std::vector<Hit>& hits1, const std::vector<Hit>& hits2,
+                                          const InsertSizeDistribution& insert) const {
+    PairedMappingResult result{};
+
+    // Meilleure paire correcte parmi les candidats vérifiés des deux mates
+    std::optional<std::pair<std::size_t, std::size_t>> bestPair;
+    int bestPairScore = 0;
+    std::size_t tiedPairs = 0;
+    for (std::size_t i = 0; i < hits1.size(); ++i) {
+        for (std::size_t j = 0; j < hits2.size(); ++j) {
+            if (!isProperPair(hits1[i], hits2[j], insert)) continue;
+            const int score = hits1[i].alignment.score + hits2[j].alignment.score;
+            if (!bestPair || score > bestPairScore) {
+                bestPair.emplace(i, j);
+                bestPairScore = score;
+                tiedPairs = 1;
+            } else if (score == bestPairScore &&
+                       (hits1[i].alignment.targetStart != hits1[bestPair->first].alignment.targetStart ||
+                        hits2[j].alignment.targetStart != hits2[bestPair->second].alignment.targetStart)) {
+                ++tiedPairs;
+            }
+        }
+    }
+
+    bool unique1 = false, unique2 = false;
+    const std::size_t best1 = hits1.empty() ? 0 : bestHitIndex(hits1, unique1);
+    const std::size_t best2 = hits2.empty() ? 0 : bestHitIndex(hits2, unique2);
+    // Placer les deux mates séparément coûte UNPAIRED_PENALTY (comme BWA-MEM)
+    const int unpairedScore = (hits1.empty() ? 0 : hits1[best1].alignment.score) +
+                              (hits2.empty() ? 0 : hits2[best2].alignment.score) - UNPAIRED_PENALTY;
+
+    if (bestPair && bestPairScore >= unpairedScore) {
+        const Hit& hit1 = hits1[bestPair->first];
+        const Hit& hit2 = hits2[bestPair->second];
+        result.mate1 = resultFromHit(read1, hit1, tiedPairs == 1);
+        result.mate2 = resultFromHit(read2, hit2, tiedPairs == 1);
+        result.properPair = true;
+        result.insertSize = *fragmentLength(hit1, hit2);
+        return result;
+    }
+
+    // Sauvetage : aucun couple de candidats ne forme une paire correcte, le mate manquant
+    // est cherché autour du meilleur placement de son partenaire
+    if (!bestPair) {
+        std::optional<Hit> rescued1, rescued2;
+        if (!hits1.empty()) rescued2 = rescueMate(read2, hits1[best1], insert);
+        if (!hits2.empty()) rescued1 = rescueMate(read1, hits2[best2], insert);
+        const int score2 = rescued2 ? hits1[best1].alignment.score + rescued2->alignment.score : 0;
+        const int score1 = rescued1 ? hits2[best2].alignment.score + rescued1->alignment.score : 0;
+        if (rescued2 && score2 >= score1 && score2 >= unpairedScore) {
+            result.mate1 = resultFromHit(read1, hits1[best1], unique1);
+            result.mate2 = resultFromHit(read2, *rescued2, unique1);
+            result.mate2Rescued = true;
+            result.properPair = true;
+            result.insertSize = *fragmentLength(hits1[best1], *rescued2);
+            return result;
+        }
+        if (rescued1 && score1 >= unpairedScore) {
+            result.mate1 = resultFromHit(read1, *rescued1, unique2);
+            result.mate2 = resultFromHit(read2, hits2[best2], unique2);
+            result.mate1Rescued = true;
+            result.properPair = true;
+            result.insertSize = *fragmentLength(*rescued1, hits2[best2]);
+            return result;
+        }
+    }
+
+    result.mate1 = resultFromHits(read1, hits1);
+    result.mate2 = resultFromHits(read2, hits2);
+    return result;
+}
+
+BandedAligner::Alignment ReadMapper::alignCandidate(std::string_view query, std::size_t pos) const {
+    // Fenêtre de référence couvrant la bande autour de la diagonale du candidat
+    const PackedSequence& reference = kmerIndex.getReference();
+    const std::size_t margin = aligner.getBandWidth();
+    const std::size_t windowStart = pos > margin ? pos - margin : 0;
+    const std::size_t windowEnd = std::min(reference.length(), pos + query.length() + margin);
+    if (windowStart >= windowEnd) return BandedAligner::Alignment{};
+
+    BandedAligner::Alignment alignment = aligner.align(
+        query, reference.extract(windowStart, windowEnd - windowStart),
+        static_cast<long>(pos - windowStart));
+    // Positions absolues dans la référence
+    alignment.targetStart += windowStart;
+    alignment.targetEnd += windowStart;
+    return alignment;
+}
+
+double ReadMapper::evaluatePosition(std::string_view read, std::size_t pos, Strand strand) const {
+    const PackedSequence& reference = kmerIndex.getReference();
     const std::size_t k = kmerIndex.getKmerSize();
     const std::size_t step = kmerIndex.getStepSize();
+    const std::size_t len = read.length();
     
-    if (pos + read.length() > reference.length()) {
+    if (len < k || pos + len > reference.length()) {
         return 0.0;
     }
     
-    std::string refSegment = reference.substr(pos, read.length());
-    if (strand == Strand::REVERSE_COMPLEMENT) {
-        refSegment = getReverseComplement(refSegment);
-    }
+    // Base j du segment de référence (complément inverse sur le brin reverse),
+    // lue directement dans la séquence compactée, sans copie du segment
+    auto refBase = [&](std::size_t j) {
+        return strand == Strand::REVERSE_COMPLEMENT ? reference.complementAt(pos + len - 1 - j)
+                                                    : reference[pos + j];
+    };
     
     int matchCount = 0;
-    for (std::size_t i = 0; i <= read.length() - k; i += step) {
-        if (read.substr(i, k) == refSegment.substr(i, k)) {
+    for (std::size_t i = 0; i <= len - k; i += step) {
+        bool match = true;
+        for (std::size_t j = i; j < i + k && match; ++j) {
+            match = read[j] == refBase(j);
+        }
+        if (match) {
             matchCount++;
         }
     }
     
-    double maxPossible = static_cast<double>(read.length() - k + step) / step;
+    double maxPossible = static_cast<double>(len - k + step) / step;
     return static_cast<double>(matchCount) / maxPossible;
 }
 
-std::string ReadMapper::generateCigar(const std::string& read, std::size_t pos, Strand strand) const {
-    (void)pos; (void)strand; // Supprime les avertissements unused parameter
-    return std::to_string(read.length()) + "M";
-}
-
-int ReadMapper::calculateEditDistance(const std::string& s1, const std::string& s2) const {
-    std::size_t min_len = std::min(s1.length(), s2.length());
-    int distance = static_cast<int>(std::max(s1.length(), s2.length()) - min_len);
-    
-    for (std::size_t i = 0; i < min_len; ++i) {
-        if (s1[i] != s2[i]) {
-            distance++;
-        }
-    }
-    return distance;
-}
-
 std::string ReadMapper::getReverseComplement(const std::string& seq) {
     static constexpr auto complement = [](char c) {
         switch (c) {
@@ -131,8 +554,12 @@ std::string ReadMapper::getReverseComplement(const std::string& seq) {
         }
     };
 
-    std::string rc;
-    rc.reserve(seq.size());
+    // Cas courant (ACGTN uniquement) : version vectorisée
+    std::string rc(seq.size(), '\0');
+    if (reverseComplementAcgtn(seq, rc.data())) {
+        return rc;
+    }
+    rc.clear();
     for (auto it = seq.rbegin(); it != seq.rend(); ++it) {
         rc += complement(*it);
     }
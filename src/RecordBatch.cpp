@@ -0,0 +1,33 @@
+#include "RecordBatch.h"
+#include <stdexcept>
+
+RecordBatchPool::RecordBatchPool(std::size_t batchCapacity) : batchCapacity(batchCapacity) {
+    if (batchCapacity == 0) {
+        throw std::invalid_argument("La capacité des lots doit être > 0");
+    }
+}
+
+std::unique_ptr<RecordBatch> RecordBatchPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!available.empty()) {
+            std::unique_ptr<RecordBatch> batch = std::move(available.back());
+            available.pop_back();
+            return batch;
+        }
+        ++allocated;
+    }
+    return std::make_unique<RecordBatch>(batchCapacity);
+}
+
+void RecordBatchPool::release(std::unique_ptr<RecordBatch> batch) {
+    if (!batch) return;
+    batch->clear();
+    std::lock_guard<std::mutex> lock(mutex);
+    available.push_back(std::move(batch));
+}
+
+std::size_t RecordBatchPool::getAllocatedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return allocated;
+}
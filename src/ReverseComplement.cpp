@@ -0,0 +1,80 @@
+#include "ReverseComplement.h"
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REVCOMP_X86 1
+#endif
+
+namespace {
+
+// Les quartets de poids faible de A, C, G, T, N (1, 3, 7, 4, E) sont distincts et
+// identiques en minuscules : une table de 16 entrées suffit, la casse (bit 0x20) et
+// le bit 0x40 sont recopiés tels quels.
+// IDENT[q] : lettre majuscule attendue pour le quartet q (une valeur de quartet différent
+// pour les autres, qui ne peut donc jamais correspondre)
+constexpr std::array<std::uint8_t, 16> IDENT = {
+    0x01, 0x41, 0x03, 0x43, 0x54, 0x04, 0x07, 0x47,
+    0x09, 0x08, 0x0B, 0x0A, 0x0D, 0x0C, 0x4E, 0x0E};
+// COMP[q] : 5 bits de poids faible du complément (T=0x14, A=0x01, C=0x03, G=0x07, N=0x0E)
+constexpr std::array<std::uint8_t, 16> COMP = {
+    0, 0x14, 0, 0x07, 0x01, 0, 0, 0x03,
+    0, 0, 0, 0, 0, 0, 0x0E, 0};
+
+// Complément d'un caractère ; faux s'il n'est pas A, C, G, T ou N
+inline bool complementBase(char c, char& out) {
+    const std::uint8_t b = static_cast<std::uint8_t>(c);
+    const unsigned q = b & 0x0F;
+    out = static_cast<char>((b & 0xE0) | COMP[q]);
+    return (b & 0xDF) == IDENT[q];
+}
+
+#ifdef REVCOMP_X86
+// 32 bases par itération ; done reçoit le nombre de bases traitées
+__attribute__((target("avx2")))
+bool reverseComplementAvx2(const char* in, std::size_t n, char* out, std::size_t& done) {
+    const __m256i ident = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(IDENT.data())));
+    const __m256i comp = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(COMP.data())));
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    const __m256i caseMask = _mm256_set1_epi8(static_cast<char>(0xDF));
+    const __m256i highMask = _mm256_set1_epi8(static_cast<char>(0xE0));
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i low = _mm256_and_si256(v, lowMask);
+        __m256i valid = _mm256_cmpeq_epi8(_mm256_and_si256(v, caseMask), _mm256_shuffle_epi8(ident, low));
+        if (static_cast<std::uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu) {
+            return false;
+        }
+        __m256i c = _mm256_or_si256(_mm256_and_si256(v, highMask), _mm256_shuffle_epi8(comp, low));
+        // Inversion des octets dans chaque moitié, puis échange des deux moitiés
+        c = _mm256_shuffle_epi8(c, reverse);
+        c = _mm256_permute2x128_si256(c, c, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + n - i - 32), c);
+    }
+    done = i;
+    return true;
+}
+#endif
+
+} // namespace
+
+bool reverseComplementAcgtn(std::string_view seq, char* out) {
+    const std::size_t n = seq.size();
+    std::size_t done = 0;
+#ifdef REVCOMP_X86
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2 && n >= 32 && !reverseComplementAvx2(seq.data(), n, out, done)) {
+        return false;
+    }
+#endif
+    for (std::size_t i = done; i < n; ++i) {
+        if (!complementBase(seq[i], out[n - 1 - i])) return false;
+    }
+    return true;
+}
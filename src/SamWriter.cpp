@@ -0,0 +1,211 @@
+#include "SamWriter.h"
+#include "ReverseComplement.h"
+#include "SequenceParser.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+
+// Tampon de la sortie : les blocs écrits font déjà plusieurs centaines de kilo-octets
+constexpr std::size_t FILE_BUFFER_SIZE = 1 << 20;
+
+// Drapeaux SAM
+constexpr unsigned FLAG_PAIRED = 0x1;
+constexpr unsigned FLAG_PROPER_PAIR = 0x2;
+constexpr unsigned FLAG_UNMAPPED = 0x4;
+constexpr unsigned FLAG_MATE_UNMAPPED = 0x8;
+constexpr unsigned FLAG_REVERSE = 0x10;
+constexpr unsigned FLAG_MATE_REVERSE = 0x20;
+constexpr unsigned FLAG_FIRST = 0x40;
+constexpr unsigned FLAG_SECOND = 0x80;
+
+// Un read sans alignement a un CIGAR vide (MappingResult{})
+bool isMapped(const MappingResult& result) {
+    return !result.cigarString.empty();
+}
+
+void appendInt(std::string& out, long long value) {
+    char digits[24];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, end);
+}
+
+void appendField(std::string& out, std::string_view field) {
+    out += '\t';
+    if (field.empty()) {
+        out += '*';
+    } else {
+        out.append(field);
+    }
+}
+
+// Séquence dans le sens de la référence : complément inverse écrit directement dans out
+void appendSequence(std::string& out, std::string_view sequence, bool reverse) {
+    out += '\t';
+    if (sequence.empty()) {
+        out += '*';
+        return;
+    }
+    if (!reverse) {
+        out.append(sequence);
+        return;
+    }
+    const std::size_t start = out.size();
+    out.resize(start + sequence.size());
+    if (!reverseComplementAcgtn(sequence, out.data() + start)) {
+        const std::string rc = SequenceParser::getReverseComplement(std::string(sequence));
+        std::copy(rc.begin(), rc.end(), out.begin() + static_cast<std::ptrdiff_t>(start));
+    }
+}
+
+void appendQuality(std::string& out, std::string_view quality, bool reverse) {
+    out += '\t';
+    if (quality.empty()) {
+        out += '*';
+    } else if (reverse) {
+        out.append(quality.rbegin(), quality.rend());
+    } else {
+        out.append(quality);
+    }
+}
+
+/**
+ * Une ligne SAM. mate : résultat du partenaire (nullptr hors paire). Comme BWA, un read
+ * non mappé dont le partenaire l'est prend la position du partenaire, et réciproquement
+ * pour RNEXT / PNEXT.
+ */
+void appendLine(std::string& out, std::string_view name, unsigned flags, std::string_view sequence,
+                std::string_view quality, const MappingResult& result, const MappingResult* mate, long long templateLength,
+                std::string_view referenceName) {
+    const bool mapped = isMapped(result);
+    const bool mateMapped = mate != nullptr && isMapped(*mate);
+    const bool reverse = mapped && result.strand == Strand::REVERSE_COMPLEMENT;
+    if (!mapped) flags |= FLAG_UNMAPPED;
+    if (reverse) flags |= FLAG_REVERSE;
+    if (mate != nullptr) {
+        if (!mateMapped) flags |= FLAG_MATE_UNMAPPED;
+        else if (mate->strand == Strand::REVERSE_COMPLEMENT) flags |= FLAG_MATE_REVERSE;
+    }
+
+    // Positions SAM (à partir de 1, 0 : aucune)
+    const long long position = mapped ? static_cast<long long>(result.referencePos) + 1
+                             : mateMapped ? static_cast<long long>(mate->referencePos) + 1 : 0;
+    const long long matePosition = mate == nullptr ? 0
+                                 : mateMapped ? static_cast<long long>(mate->referencePos) + 1 : position;
+
+    out.append(name);
+    out += '\t';
+    appendInt(out, flags);
+    appendField(out, position > 0 ? referenceName : std::string_view());
+    out += '\t';
+    appendInt(out, position);
+    out += '\t';
+    appendInt(out, mapped && result.isUnique ? SamWriter::UNIQUE_MAPQ : 0);
+    appendField(out, mapped ? std::string_view(result.cigarString) : std::string_view());
+    appendField(out, matePosition > 0 ? std::string_view("=") : std::string_view());
+    out += '\t';
+    appendInt(out, matePosition);
+    out += '\t';
+    appendInt(out, templateLength);
+    appendSequence(out, sequence, reverse);
+    appendQuality(out, quality, reverse);
+    if (mapped) {
+        out.append("\tNM:i:");
+        appendInt(out, result.editDistance);
+        out.append("\tAS:i:");
+        appendInt(out, result.alignmentScore);
+    }
+    out += '\n';
+}
+
+} // namespace
+
+SamWriter::SamWriter(const std::string& filePath) {
+    if (filePath == "-") {
+        file = stdout;
+    } else {
+        file = std::fopen(filePath.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("Erreur : Impossible d'ouvrir le fichier " + filePath);
+        }
+        ownsFile = true;
+        std::setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+    }
+}
+
+SamWriter::~SamWriter() {
+    if (ownsFile) {
+        std::fclose(file);
+    } else {
+        std::fflush(file);
+    }
+}
+
+void SamWriter::writeHeader(const std::vector<Reference>& references, const std::string& commandLine) {
+    std::string header = "@HD\tVN:1.6\tSO:unsorted\n";
+    for (const Reference& reference : references) {
+        header.append("@SQ\tSN:");
+        header.append(reference.name);
+        header.append("\tLN:");
+        appendInt(header, static_cast<long long>(reference.length));
+        header += '\n';
+    }
+    header.append("@PG\tID:mapper\tPN:mapper");
+    if (!commandLine.empty()) {
+        header.append("\tCL:");
+        header.append(commandLine);
+    }
+    header += '\n';
+    writeBlock(header);
+}
+
+void SamWriter::writeBlock(std::string_view block) {
+    if (!block.empty() && std::fwrite(block.data(), 1, block.size(), file) != block.size()) {
+        throw std::runtime_error("Erreur : Écriture du fichier SAM impossible");
+    }
+}
+
+void SamWriter::flush() {
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Erreur : Écriture du fichier SAM impossible");
+    }
+}
+
+std::string_view SamWriter::readName(std::string_view header) {
+    if (!header.empty() && (header[0] == '@' || header[0] == '>')) header.remove_prefix(1);
+    return header.substr(0, header.find_first_of(" \t"));
+}
+
+void SamWriter::formatRecord(std::string& out, const ReadRecord& record, const MappingResult& result,
+                             std::string_view referenceName) {
+    appendLine(out, readName(record.header), 0, record.sequence, record.quality, result, nullptr, 0, referenceName);
+}
+
+void SamWriter::formatRecord(std::string& out, const RecordBatch& batch, std::size_t i,
+                             const MappingResult& result, std::string_view referenceName) {
+    appendLine(out, readName(batch.header(i)), 0, batch.sequence(i), batch.quality(i), result, nullptr, 0,
+               referenceName);
+}
+
+void SamWriter::formatPair(std::string& out, const ReadPair& pair, const PairedMappingResult& result,
+                           std::string_view referenceName) {
+    // Même QNAME pour les deux mates : le suffixe /1 ou /2 éventuel est retiré
+    std::string_view name = readName(pair.mate1.header);
+    if (name.size() > 2 && name[name.size() - 2] == '/' && (name.back() == '1' || name.back() == '2')) {
+        name.remove_suffix(2);
+    }
+
+    // TLEN positif pour le mate le plus à gauche (le mate forward d'une paire FR)
+    long long length1 = 0, length2 = 0;
+    if (result.properPair) {
+        const long long insert = static_cast<long long>(result.insertSize);
+        const bool firstLeft = result.mate1.strand == Strand::FORWARD;
+        length1 = firstLeft ? insert : -insert;
+        length2 = -length1;
+    }
+
+    const unsigned flags = FLAG_PAIRED | (result.properPair ? FLAG_PROPER_PAIR : 0);
+    appendLine(out, name, flags | FLAG_FIRST, pair.mate1.sequence, pair.mate1.quality, result.mate1, &result.mate2, length1, referenceName);
+    appendLine(out, name, flags | FLAG_SECOND, pair.mate2.sequence, pair.mate2.quality, result.mate2, &result.mate1, length2, referenceName);
+}
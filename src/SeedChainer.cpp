@@ -0,0 +1,123 @@
+#include "SeedChainer.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace {
+
+// Brin en poids fort : les ancres forward puis reverse, chacune par diagonale croissante
+std::uint64_t sortKey(const Anchor& anchor) {
+    return (static_cast<std::uint64_t>(anchor.reverse) << 63) | anchor.diagonal;
+}
+
+// En dessous, le tri par comparaison est plus rapide que les passes radix
+constexpr std::size_t RADIX_THRESHOLD = 64;
+
+} // namespace
+
+SeedChainer::SeedChainer(std::size_t kmerSize, std::size_t bandWidth, std::size_t maxPredecessors)
+    : kmerSize(kmerSize), bandWidth(bandWidth), maxPredecessors(maxPredecessors) {}
+
+void SeedChainer::sortByDiagonal(std::vector<Anchor>& anchors) {
+    const std::size_t n = anchors.size();
+    if (n < RADIX_THRESHOLD) {
+        std::stable_sort(anchors.begin(), anchors.end(),
+                         [](const Anchor& a, const Anchor& b) { return sortKey(a) < sortKey(b); });
+        return;
+    }
+
+    // Octets qui varient d'une clé à l'autre : les diagonales d'un read sont proches,
+    // seules deux ou trois passes sur huit sont en général nécessaires
+    std::uint64_t varying = 0;
+    const std::uint64_t reference = sortKey(anchors[0]);
+    for (const Anchor& anchor : anchors) varying |= sortKey(anchor) ^ reference;
+
+    thread_local std::vector<Anchor> buffer;
+    buffer.resize(n);
+    Anchor* source = anchors.data();
+    Anchor* target = buffer.data();
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) continue;
+        std::array<std::size_t, 256> offsets{};
+        for (std::size_t i = 0; i < n; ++i) ++offsets[(sortKey(source[i]) >> shift) & 0xFF];
+        std::size_t total = 0;
+        for (std::size_t& offset : offsets) {
+            const std::size_t count = offset;
+            offset = total;
+            total += count;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            target[offsets[(sortKey(source[i]) >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, target);
+    }
+    if (source != anchors.data()) std::copy(source, source + n, anchors.data());
+}
+
+std::vector<Chain> SeedChainer::chain(std::vector<Anchor>& anchors) const {
+    std::vector<Chain> chains;
+    sortByDiagonal(anchors);
+
+    // Groupes : même brin, diagonales consécutives à moins de bandWidth
+    for (std::size_t begin = 0; begin < anchors.size(); ) {
+        std::size_t end = begin + 1;
+        while (end < anchors.size() && anchors[end].reverse == anchors[end - 1].reverse &&
+               anchors[end].diagonal - anchors[end - 1].diagonal <= bandWidth) {
+            ++end;
+        }
+        chains.push_back(chainCluster(anchors.data() + begin, anchors.data() + end));
+        begin = end;
+    }
+
+    std::sort(chains.begin(), chains.end(), [](const Chain& a, const Chain& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.reverse != b.reverse) return !a.reverse;
+        return a.diagonal < b.diagonal;
+    });
+    return chains;
+}
+
+Chain SeedChainer::chainCluster(Anchor* first, Anchor* last) const {
+    // Ordre colinéaire : position dans le read, puis diagonale
+    std::sort(first, last, [](const Anchor& a, const Anchor& b) {
+        return a.readPos != b.readPos ? a.readPos < b.readPos : a.diagonal < b.diagonal;
+    });
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    const long k = static_cast<long>(kmerSize);
+    const long band = static_cast<long>(bandWidth);
+
+    thread_local std::vector<long> score;
+    thread_local std::vector<std::size_t> previous;
+    score.assign(n, k);
+    previous.assign(n, n); // n : début de chaîne
+
+    std::size_t best = 0;
+    for (std::size_t j = 0; j < n; ++j) {
+        const long readJ = first[j].readPos;
+        const long diagonalJ = static_cast<long>(first[j].diagonal);
+        // Prédécesseurs les plus proches d'abord : à score égal, la chaîne la plus serrée
+        const std::size_t start = j > maxPredecessors ? j - maxPredecessors : 0;
+        for (std::size_t i = j; i-- > start; ) {
+            const long dq = readJ - static_cast<long>(first[i].readPos);
+            const long gap = diagonalJ - static_cast<long>(first[i].diagonal);
+            const long dr = dq + gap;
+            if (dq <= 0 || dr <= 0 || std::labs(gap) > band) continue;
+            const long candidate = score[i] + std::min({dq, dr, k}) - std::labs(gap);
+            if (candidate > score[j]) {
+                score[j] = candidate;
+                previous[j] = i;
+            }
+        }
+        if (score[j] > score[best]) best = j;
+    }
+
+    Chain result{0, first[best].reverse != 0, static_cast<int>(score[best]), 0};
+    std::size_t anchor = best;
+    for (;;) {
+        ++result.anchorCount;
+        if (previous[anchor] == n) break;
+        anchor = previous[anchor];
+    }
+    result.diagonal = static_cast<std::size_t>(first[anchor].diagonal);
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "SequenceParser.h"
+#include "ReverseComplement.h"
 #include<algorithm>
 #include <vector>
 #include <iostream>
@@ -84,7 +85,13 @@ std::string SequenceParser::getReverseComplement(const std::string& sequence) {
         return table;
     };
     static constexpr auto complementTable = buildComplementTable();
-    std::string complement ;
+
+    // Cas courant (ACGTN uniquement) : version vectorisée, sans passer par la table
+    std::string complement(sequence.size(), '\0');
+    if (reverseComplementAcgtn(sequence, complement.data())) {
+        return complement;
+    }
+    complement.clear();
     complement.reserve(sequence.size()); // Réserve la mémoire pour la séquence complémentaire
 
     for (char base : sequence) {
@@ -1,28 +1,178 @@
 #include "SuffixArray.h"
 #include <algorithm>  // Pour utiliser std::sort>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Constructeur
-SuffixArray::SuffixArray(const std::string& inputText) : text(inputText + '$') {
-    buildSuffixArray(); // Construire la table des suffixes
+SuffixArray::SuffixArray(const std::string& inputText, BuildMethod method, int numThreads,
+                         unsigned indexWidth)
+    : numThreads(numThreads) {
+    // Séquence compactée sur 2 bits ; la sentinelle '$' est virtuelle (position textLength - 1)
+    sequence = PackedSequence(inputText);
+    textLength = sequence.length() + 1;
+    // Largeur des entrées de la table : choisie d'après la longueur du texte, ou imposée
+    // (4, 5 ou 8 octets, assez pour représenter toutes les positions)
+    const unsigned minimumWidth = IndexArray::widthFor(textLength);
+    if (indexWidth != 0 && ((indexWidth != 4 && indexWidth != 5 && indexWidth != 8) || indexWidth < minimumWidth)) {
+        throw std::invalid_argument("Largeur des entrées de la table des suffixes invalide : " +
+                                    std::to_string(indexWidth) + " (4, 5 ou 8 octets, au moins " +
+                                    std::to_string(minimumWidth) + ")");
+    }
+    this->indexWidth = indexWidth != 0 ? indexWidth : minimumWidth;
+
+#ifdef _OPENMP
+    if (this->numThreads <= 0) this->numThreads = omp_get_max_threads();
+#else
+    this->numThreads = 1;
+#endif
+    buildSuffixArray(method); // Construire la table des suffixes
     buildLcpArray();    // Construire la table LCP (facultatif)
 }
 
+void SuffixArray::save(IndexFile::Writer& writer) const {
+    writer.addSection(IndexFile::PACKED_TEXT, sequence.wordData(),
+                      sequence.wordCount() * sizeof(std::uint64_t));
+    writer.addSection(IndexFile::N_RUNS, sequence.runData(),
+                      sequence.runSize() * sizeof(PackedSequence::NRun));
+    writer.addSection(IndexFile::SUFFIX_ARRAY, suffixArray.data(), suffixArray.sizeBytes());
+    writer.addSection(IndexFile::LCP, lcpArray.smallData(), lcpArray.size());
+    writer.addSection(IndexFile::LCP_OVERFLOW, lcpArray.overflowData(),
+                      lcpArray.overflowSize() * sizeof(CompactLcpArray::OverflowEntry));
+    if (prefixLength > 0) {
+        writer.addSection(IndexFile::PREFIX_TABLE, prefixTable.data(), prefixTable.sizeBytes());
+    }
+}
+
+SuffixArray SuffixArray::load(const IndexFile::Reader& reader) {
+    SuffixArray sa;
+    sa.mapping = reader.getMapping();
+
+    std::string_view textSection = reader.getSection(IndexFile::PACKED_TEXT);
+    std::string_view runSection = reader.getSection(IndexFile::N_RUNS);
+    std::string_view saSection = reader.getSection(IndexFile::SUFFIX_ARRAY);
+    std::string_view lcpSection = reader.getSection(IndexFile::LCP);
+    std::string_view overflowSection = reader.getSection(IndexFile::LCP_OVERFLOW);
+
+    // La largeur des entrées SA se déduit de la taille de la section
+    const size_t bases = reader.getMetadata().referenceLength;
+    const size_t n = bases + 1;
+    const size_t width = saSection.size() / n;
+    if (textSection.size() != (bases + PackedSequence::BASES_PER_WORD - 1) / PackedSequence::BASES_PER_WORD * sizeof(std::uint64_t) ||
+        runSection.size() % sizeof(PackedSequence::NRun) != 0 ||
+        (width != 4 && width != 5 && width != 8) || saSection.size() != n * width ||
+        lcpSection.size() != n ||
+        overflowSection.size() % sizeof(CompactLcpArray::OverflowEntry) != 0) {
+        throw std::runtime_error("Erreur : Tables SA/LCP incohérentes dans l'index");
+    }
+
+    // Les sections sont alignées sur 64 octets : lecture directe dans la projection
+    sa.sequence = PackedSequence::view(
+        reinterpret_cast<const std::uint64_t*>(textSection.data()), bases,
+        reinterpret_cast<const PackedSequence::NRun*>(runSection.data()),
+        runSection.size() / sizeof(PackedSequence::NRun));
+    sa.textLength = n;
+    sa.indexWidth = static_cast<unsigned>(width);
+    sa.suffixArray = IndexArray::view(saSection.data(), n, sa.indexWidth);
+    sa.lcpArray = CompactLcpArray::view(
+        reinterpret_cast<const unsigned char*>(lcpSection.data()), n,
+        reinterpret_cast<const CompactLcpArray::OverflowEntry*>(overflowSection.data()),
+        overflowSection.size() / sizeof(CompactLcpArray::OverflowEntry));
+
+    // Table des q-grammes facultative : 4^q + 1 entrées de la largeur de la table SA
+    if (reader.hasSection(IndexFile::PREFIX_TABLE)) {
+        std::string_view tableSection = reader.getSection(IndexFile::PREFIX_TABLE);
+        size_t entries = tableSection.size() / width;
+        unsigned q = 0;
+        while ((size_t(1) << (2 * q)) + 1 < entries) ++q;
+        if (tableSection.size() != entries * width || (size_t(1) << (2 * q)) + 1 != entries) {
+            throw std::runtime_error("Erreur : Table des q-grammes incohérente dans l'index");
+        }
+        sa.prefixTable = IndexArray::view(tableSection.data(), entries, sa.indexWidth);
+        sa.prefixLength = q;
+    }
+    return sa;
+}
+
+
+// table des q-grammes **********************************
+unsigned SuffixArray::defaultPrefixLength(size_t textLength) {
+    unsigned q = 0;
+    while (q < 12 && (size_t(1) << (2 * (q + 1))) <= textLength / 4) {
+        ++q;
+    }
+    return q;
+}
+
+void SuffixArray::buildPrefixTable(unsigned q) {
+    prefixLength = std::min(q, 16u);
+    if (prefixLength == 0) {
+        prefixTable = IndexArray();
+        return;
+    }
+
+    // Les suffixes dont les q premières bases sont ACGT apparaissent dans la table SA
+    // par ordre croissant de code : un seul balayage suffit pour fixer le début de chaque case.
+    const size_t buckets = size_t(1) << (2 * prefixLength);
+    const size_t n = suffixArray.size();
+    const size_t bases = sequence.length();
+    prefixTable.assign(buckets + 1, indexWidth);
+
+    size_t next = 0;
+    for (size_t r = 0; r < n; ++r) {
+        size_t pos = suffixArray[r];
+        if (pos + prefixLength > bases || sequence.hasNInRange(pos, prefixLength)) continue;
+        size_t code = sequence.packedCode(pos, prefixLength);
+        while (next <= code) {
+            prefixTable.set(next++, r);
+        }
+    }
+    while (next <= buckets) {
+        prefixTable.set(next++, n);
+    }
+}
 
 // methode de ma table SA ********************************
-bool compareSuffixes(size_t i, size_t j, const std::string& s) {
-    const size_t n = s.length();
+bool compareSuffixes(size_t i, size_t j, const SuffixArray& sa) {
+    const size_t n = sa.getReferenceLength();
     while (i < n && j < n) {
-        if (s[i] < s[j]) return true;
-        if (s[i] > s[j]) return false;
+        char ci = sa.charAt(i);
+        char cj = sa.charAt(j);
+        if (ci < cj) return true;
+        if (ci > cj) return false;
         ++i;
         ++j;
     }
     return j != n; // i a attesize_t la fin → j est plus long, donc i < j
 }
 
+int SuffixArray::compareSuffix(size_t pos, std::string_view motif) const {
+    const size_t m = motif.length();
+    const size_t len = std::min(m, textLength - pos);
+    for (size_t i = 0; i < len; ++i) {
+        char c = charAt(pos + i);
+        if (c != motif[i]) return c < motif[i] ? -1 : 1;
+    }
+    return len < m ? -1 : 0; // suffixe plus court que le motif
+}
+
+
+void SuffixArray::buildSuffixArray(BuildMethod method){
+    if (method == BuildMethod::NAIVE_SORT) {
+        buildSuffixArrayNaive();
+    } else if (method == BuildMethod::PARALLEL_DOUBLING) {
+        buildSuffixArrayParallel();
+    } else {
+        buildSuffixArraySais();
+    }
+}
 
-void SuffixArray::buildSuffixArray(){
-    size_t n = text.length();
+void SuffixArray::buildSuffixArrayNaive(){
+    size_t n = textLength;
     std::vector<size_t> indices(n);
 
     // Initialiser le vecteur d'indices
@@ -32,18 +182,374 @@ void SuffixArray::buildSuffixArray(){
 
     // Trier les indices en utilisant la fonction de comparaison personnalisée
     std::sort(indices.begin(), indices.end(), [this](size_t i, size_t j) {
-        return compareSuffixes(i, j, text);
+        return compareSuffixes(i, j, *this);
     });
 
     // Mettre à jour la table des suffixes
-    suffixArray = indices;
+    suffixArray.assign(n, indexWidth);
+    for (size_t i = 0; i < n; ++i) {
+        suffixArray.set(i, indices[i]);
+    }
 
 } 
+
+// construction SA-IS *************************************
+/**
+ * Implémentation de l'algorithme SA-IS (Nong, Zhang et Chan, 2009).
+ *
+ * @par Principe :
+ * Chaque suffixe est de type S (plus petit que son suivant) ou L (plus grand).
+ * Les suffixes LMS (S précédé d'un L) sont placés en fin de leur bucket, puis
+ * les suffixes L et S sont induits par deux balayages de la table.
+ * Les sous-chaînes LMS triées reçoivent un nom ; si les noms ne sont pas tous
+ * distincts, on résout récursivement le problème sur la chaîne réduite (taille ≤ n/2).
+ *
+ * @par Complexité : O(n) en temps, O(n) mots en mémoire.
+ *
+ * @note Le texte s doit se terminer par une sentinelle unique de valeur 0.
+ */
+namespace {
+
+template <typename Index>
+void getBuckets(const Index* s, Index n, Index alphabetSize, std::vector<Index>& bkt, bool end) {
+    std::fill(bkt.begin(), bkt.end(), 0);
+    for (Index i = 0; i < n; ++i) {
+        ++bkt[s[i]];
+    }
+    Index sum = 0;
+    for (Index c = 0; c < alphabetSize; ++c) {
+        sum += bkt[c];
+        bkt[c] = end ? sum : sum - bkt[c];
+    }
+}
+
+template <typename Index>
+void induceSort(const Index* s, Index* sa, Index n, Index alphabetSize,
+                const std::vector<bool>& isS, std::vector<Index>& bkt) {
+    const Index EMPTY = std::numeric_limits<Index>::max();
+
+    // Induction des suffixes de type L (balayage gauche → droite)
+    getBuckets(s, n, alphabetSize, bkt, false);
+    for (Index i = 0; i < n; ++i) {
+        Index j = sa[i];
+        if (j != EMPTY && j > 0 && !isS[j - 1]) {
+            sa[bkt[s[j - 1]]++] = j - 1;
+        }
+    }
+
+    // Induction des suffixes de type S (balayage droite → gauche)
+    getBuckets(s, n, alphabetSize, bkt, true);
+    for (Index i = n; i-- > 0;) {
+        Index j = sa[i];
+        if (j != EMPTY && j > 0 && isS[j - 1]) {
+            sa[--bkt[s[j - 1]]] = j - 1;
+        }
+    }
+}
+
+template <typename Index>
+void sais(const Index* s, Index* sa, Index n, Index alphabetSize) {
+    const Index EMPTY = std::numeric_limits<Index>::max();
+    if (n == 1) {
+        sa[0] = 0;
+        return;
+    }
+
+    // Classification des suffixes : true = type S, false = type L
+    std::vector<bool> isS(n);
+    isS[n - 1] = true;
+    for (Index i = n - 1; i-- > 0;) {
+        isS[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && isS[i + 1]);
+    }
+    auto isLms = [&isS](Index i) { return i > 0 && isS[i] && !isS[i - 1]; };
+
+    // Étape 1 : tri des sous-chaînes LMS
+    std::vector<Index> bkt(alphabetSize);
+    getBuckets(s, n, alphabetSize, bkt, true);
+    std::fill(sa, sa + n, EMPTY);
+    for (Index i = 1; i < n; ++i) {
+        if (isLms(i)) sa[--bkt[s[i]]] = i;
+    }
+    induceSort(s, sa, n, alphabetSize, isS, bkt);
+
+    // Compacter les LMS triés au début de sa
+    Index n1 = 0;
+    for (Index i = 0; i < n; ++i) {
+        if (isLms(sa[i])) sa[n1++] = sa[i];
+    }
+
+    // Étape 2 : nommer les sous-chaînes LMS (deux LMS voisins ne sont jamais à moins de 2 positions)
+    std::fill(sa + n1, sa + n, EMPTY);
+    Index name = 0;
+    Index prev = EMPTY;
+    for (Index i = 0; i < n1; ++i) {
+        Index pos = sa[i];
+        bool diff = (prev == EMPTY);
+        for (Index d = 0; !diff; ++d) {
+            if (s[pos + d] != s[prev + d] || isS[pos + d] != isS[prev + d]) {
+                diff = true;
+            } else if (d > 0 && (isLms(pos + d) || isLms(prev + d))) {
+                break;
+            }
+        }
+        if (diff) {
+            ++name;
+            prev = pos;
+        }
+        sa[n1 + pos / 2] = name - 1;
+    }
+    for (Index i = n, j = n; i-- > n1;) {
+        if (sa[i] != EMPTY) sa[--j] = sa[i];
+    }
+
+    // Étape 3 : trier les suffixes LMS (récursion si des noms sont dupliqués)
+    Index* s1 = sa + n - n1;
+    Index* sa1 = sa;
+    if (name < n1) {
+        sais(s1, sa1, n1, name);
+    } else {
+        for (Index i = 0; i < n1; ++i) sa1[s1[i]] = i;
+    }
+
+    // Étape 4 : induire la table complète à partir des LMS triés
+    for (Index i = 1, j = 0; i < n; ++i) {
+        if (isLms(i)) s1[j++] = i;
+    }
+    for (Index i = 0; i < n1; ++i) {
+        sa1[i] = s1[sa1[i]];
+    }
+    std::fill(sa + n1, sa + n, EMPTY);
+    getBuckets(s, n, alphabetSize, bkt, true);
+    for (Index i = n1; i-- > 0;) {
+        Index j = sa[i];
+        sa[i] = EMPTY;
+        sa[--bkt[s[j]]] = j;
+    }
+    induceSort(s, sa, n, alphabetSize, isS, bkt);
+}
+
+// Prépare le texte (alphabet compact, sentinelle à 0) puis lance SA-IS avec des entiers Index
+template <typename Index>
+void saisOnText(const PackedSequence& text, Index* sa) {
+    const size_t n = text.length() + 1;
+
+    // Alphabet compact : la sentinelle finale vaut 0, les autres caractères
+    // sont renumérotés à partir de 1 en conservant l'ordre ASCII
+    std::array<size_t, 256> rankOf{};
+    for (size_t i = 0; i + 1 < n; ++i) {
+        rankOf[static_cast<unsigned char>(text[i])] = 1;
+    }
+    size_t alphabetSize = 1;
+    for (auto& r : rankOf) {
+        if (r) r = alphabetSize++;
+    }
+
+    std::vector<Index> s(n);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        s[i] = static_cast<Index>(rankOf[static_cast<unsigned char>(text[i])]);
+    }
+    s[n - 1] = 0;
+
+    sais<Index>(s.data(), sa, static_cast<Index>(n), static_cast<Index>(alphabetSize));
+}
+
+} // namespace
+
+void SuffixArray::buildSuffixArraySais(){
+    const size_t n = textLength;
+    suffixArray.assign(n, indexWidth);
+
+    // Largeurs 4 et 8 : SA-IS écrit directement dans le tampon de la table.
+    // Largeur 5 : passage par une table 64 bits temporaire, puis compactage.
+    if (indexWidth == 4 && n < std::numeric_limits<std::uint32_t>::max()) {
+        saisOnText<std::uint32_t>(sequence, reinterpret_cast<std::uint32_t*>(suffixArray.mutableData()));
+    } else if (indexWidth == 8) {
+        saisOnText<std::uint64_t>(sequence, reinterpret_cast<std::uint64_t*>(suffixArray.mutableData()));
+    } else {
+        std::vector<std::uint64_t> full(n);
+        saisOnText<std::uint64_t>(sequence, full.data());
+        for (size_t i = 0; i < n; ++i) {
+            suffixArray.set(i, full[i]);
+        }
+    }
+}
+// construction parallèle par doublement de préfixe ******
+/**
+ * @par Principe (Manber-Myers) :
+ * À l'étape h, chaque suffixe i a un rang égal à celui de son préfixe de longueur h.
+ * Trier les paires (rang[i], rang[i + h]) donne l'ordre des préfixes de longueur 2h.
+ * On s'arrête dès que tous les rangs sont distincts (⌈log2(LCP max)⌉ étapes).
+ *
+ * @par Parallélisation :
+ * Les paires sont empaquetées dans une clé 64 bits et triées par un tri radix LSD
+ * (chiffres de 8 bits) : histogrammes locaux à chaque thread, préfixes globaux,
+ * puis dispersion stable. Le calcul des nouveaux rangs est un préfixe parallèle.
+ *
+ * @note Les rangs sont stockés sur 32 bits : au-delà de 2^32 - 1 caractères,
+ * la construction retombe sur SA-IS.
+ */
+namespace {
+
+struct DoublingEntry {
+    std::uint64_t key;
+    std::uint32_t index;
+};
+
+// Découpage de [0, n) en blocs contigus, un par thread
+inline void threadRange(size_t n, int thread, int threads, size_t& begin, size_t& end) {
+    begin = n * thread / threads;
+    end = n * (thread + 1) / threads;
+}
+
+void parallelRadixSort(std::vector<DoublingEntry>& entries, std::vector<DoublingEntry>& buffer,
+                       const std::vector<int>& shifts, int numThreads) {
+    const size_t n = entries.size();
+    std::vector<size_t> histogram(static_cast<size_t>(numThreads) * 256);
+
+    for (int shift : shifts) {
+        #pragma omp parallel num_threads(numThreads)
+        {
+            int thread = 0, threads = 1;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+            threads = omp_get_num_threads();
+#endif
+            size_t begin, end;
+            threadRange(n, thread, threads, begin, end);
+            size_t* local = histogram.data() + static_cast<size_t>(thread) * 256;
+
+            std::fill(local, local + 256, 0);
+            for (size_t i = begin; i < end; ++i) {
+                ++local[(entries[i].key >> shift) & 0xFF];
+            }
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                size_t offset = 0;
+                for (size_t digit = 0; digit < 256; ++digit) {
+                    for (int t = 0; t < threads; ++t) {
+                        size_t count = histogram[static_cast<size_t>(t) * 256 + digit];
+                        histogram[static_cast<size_t>(t) * 256 + digit] = offset;
+                        offset += count;
+                    }
+                }
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                buffer[local[(entries[i].key >> shift) & 0xFF]++] = entries[i];
+            }
+        }
+        entries.swap(buffer);
+    }
+}
+
+} // namespace
+
+void SuffixArray::buildSuffixArrayParallel(){
+    const size_t n = textLength;
+    if (n >= std::numeric_limits<std::uint32_t>::max()) {
+        buildSuffixArraySais();
+        return;
+    }
+
+    // Rangs initiaux : rang du premier caractère (la sentinelle finale vaut 0)
+    std::array<std::uint32_t, 256> rankOf{};
+    for (size_t i = 0; i + 1 < n; ++i) {
+        rankOf[static_cast<unsigned char>(sequence[i])] = 1;
+    }
+    std::uint32_t alphabetSize = 1;
+    for (auto& r : rankOf) {
+        if (r) r = alphabetSize++;
+    }
+    std::vector<std::uint32_t> rank(n);
+    #pragma omp parallel for num_threads(numThreads)
+    for (size_t i = 0; i < n - 1; ++i) {
+        rank[i] = rankOf[static_cast<unsigned char>(sequence[i])];
+    }
+    rank[n - 1] = 0;
+
+    // Octets utiles d'une clé : les rangs (+1 pour le second) tiennent sur rankBytes octets
+    int rankBytes = 1;
+    while (rankBytes < 4 && (static_cast<std::uint64_t>(n) >> (8 * rankBytes)) != 0) {
+        ++rankBytes;
+    }
+    std::vector<int> shifts;
+    for (int b = 0; b < rankBytes; ++b) shifts.push_back(8 * b);
+    for (int b = 0; b < rankBytes; ++b) shifts.push_back(32 + 8 * b);
+
+    std::vector<DoublingEntry> entries(n), buffer(n);
+    std::vector<std::uint32_t> newRank(n);
+    std::vector<size_t> blockSums(static_cast<size_t>(numThreads) + 1);
+
+    for (size_t h = 1; ; h *= 2) {
+        #pragma omp parallel for num_threads(numThreads)
+        for (size_t i = 0; i < n; ++i) {
+            std::uint64_t second = (i + h < n) ? static_cast<std::uint64_t>(rank[i + h]) + 1 : 0;
+            entries[i].key = (static_cast<std::uint64_t>(rank[i]) << 32) | second;
+            entries[i].index = static_cast<std::uint32_t>(i);
+        }
+
+        parallelRadixSort(entries, buffer, shifts, numThreads);
+
+        // Nouveaux rangs : nombre de clés distinctes avant chaque entrée (préfixe parallèle)
+        size_t distinct = 0;
+        #pragma omp parallel num_threads(numThreads)
+        {
+            int thread = 0, threads = 1;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+            threads = omp_get_num_threads();
+#endif
+            size_t begin, end;
+            threadRange(n, thread, threads, begin, end);
+            size_t localCount = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (i > 0 && entries[i].key != entries[i - 1].key) ++localCount;
+            }
+            blockSums[thread + 1] = localCount;
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                blockSums[0] = 0;
+                for (int t = 0; t < threads; ++t) blockSums[t + 1] += blockSums[t];
+                distinct = blockSums[threads] + 1;
+            }
+
+            size_t current = blockSums[thread];
+            for (size_t i = begin; i < end; ++i) {
+                if (i > 0 && entries[i].key != entries[i - 1].key) ++current;
+                newRank[entries[i].index] = static_cast<std::uint32_t>(current);
+            }
+        }
+        rank.swap(newRank);
+
+        if (distinct == n || h >= n) break;
+    }
+
+    suffixArray.assign(n, indexWidth);
+    #pragma omp parallel for num_threads(numThreads)
+    for (size_t i = 0; i < n; ++i) {
+        suffixArray.set(i, entries[i].index);
+    }
+}
+
  //* construire ma table  lcp *****************************
  void SuffixArray::buildLcpArray() {
-    const size_t n = text.length();
-    lcpArray.resize(n); // Alloue l'espace pour le tableau LCP
-    std::vector<size_t> rank(n); // Tableau de rang inverse
+    // Le rang inverse tient sur 32 bits tant que la table SA aussi
+    if (indexWidth == 4) {
+        buildLcpArrayWithRank<std::uint32_t>();
+    } else {
+        buildLcpArrayWithRank<size_t>();
+    }
+}
+
+template <typename Rank>
+void SuffixArray::buildLcpArrayWithRank() {
+    const size_t n = textLength;
+    lcpArray.resize(n); // Alloue l'espace pour le tableau LCP (un octet par entrée)
+    std::vector<Rank> rank(n); // Tableau de rang inverse
 
     /**
      * @brief Phase 1 : Construction du rang inverse (parallélisable)
@@ -55,16 +561,16 @@ void SuffixArray::buildSuffixArray(){
      * @par Optimisation :
      * La boucle est parallélisable car chaque écriture est indépendante
      */
-    #pragma omp parallel for  // Directive OpenMP pour parallélisation
+    #pragma omp parallel for num_threads(numThreads)  // Directive OpenMP pour parallélisation
     for (size_t i = 0; i < n; ++i) {
-        rank[suffixArray[i]] = i; // rank[suffixArray[i]] = position dans le SA
+        rank[suffixArray[i]] = static_cast<Rank>(i); // rank[suffixArray[i]] = position dans le SA
     }
 
     size_t k = 0; // Compteur de préfixe commun
     for (size_t i = 0; i < n; ++i) {
         if (rank[i] == n - 1) {
             // Cas particulier : dernier suffixe dans l'ordre lexicographique
-            lcpArray[rank[i]] = 0;
+            lcpArray.setValue(rank[i], 0);
             continue;
         }
         
@@ -81,19 +587,20 @@ void SuffixArray::buildSuffixArray(){
         k = (k > 0) ? k - 1 : 0;
         
         // Calcul du LCP entre text[i..] et text[j..]
-        while (i + k < n && j + k < n && text[i + k] == text[j + k]) {
+        while (i + k < n && j + k < n && charAt(i + k) == charAt(j + k)) {
             ++k;
         }
-        lcpArray[rank[i]] = k; // Stocke la longueur du LCP
+        lcpArray.setValue(rank[i], k); // Stocke la longueur du LCP
     }
+    lcpArray.finalize(); // Trie la table de débordement (LCP ≥ 255)
 }
     //methode gitter de SA 
-    const std::vector<size_t>& SuffixArray::getSuffixArray() const{
+    const IndexArray& SuffixArray::getSuffixArray() const{
         return suffixArray;
     }
 
     //get ma table lcp
-    const std::vector<size_t>& SuffixArray::getLcpArray() const{
+    const CompactLcpArray& SuffixArray::getLcpArray() const{
         return lcpArray;
     }
     
@@ -103,28 +610,19 @@ bool SuffixArray::search(const std::string& motif) const{
     size_t right = suffixArray.size() - 1 ; 
     size_t Pos;
     size_t mid;
-    size_t m = motif.length();
 
     while(left <= right){
         mid = left + (right - left) / 2;  // calculer le milieu de sa 
 
         Pos = suffixArray[mid]; // Position du suffixe dans la chaîne d'origine
         //std::string suffix = text.substr(Pas); // Extraire le suffixe à partir de cette position dans le motif d'origne
-        bool match = true;
-        for( size_t i=0; i < m; ++i){
-            if (Pos + i > text.length() || motif[i] != text[Pos + i]){
-                match = false; // le motif ne correspond Pos au suffixe
-                break;
-            }
-            
-        }
-
+        int cmp = compareSuffix(Pos, motif);
 
         // Comparer le motif avec le suffixe
-        if(match){
+        if(cmp == 0){
             return true; // motif trouvé
         }
-        else if (text.compare(Pos, m, motif) < 0){  // si le suffixe lexicographiquement inférieur au motif → on va à droite.
+        else if (cmp < 0){  // si le suffixe lexicographiquement inférieur au motif → on va à droite.
          left = mid + 1; // chercher dans la partie droite
         } else{
             right = mid - 1; // chercher dans la partie gauche
@@ -136,54 +634,119 @@ bool SuffixArray::search(const std::string& motif) const{
 
 
 
-//get lowerBound
-size_t  SuffixArray::lowerBound(const std::string& motif) const{
-    if (motif.empty() || motif.length() > text.length()) return suffixArray.size();
-    
-    size_t  left = 0;
-    size_t  right = suffixArray.size()-1; //-1 pour ne pas calculer le $ a la fin de mon motif
-    size_t  result = suffixArray.size(); //initialiser le resultat a la taille de ma table SA
-    
-    
-    while(left <= right){
-        size_t  mid = left + (right - left) / 2; //calculer le milieu
-        
-        size_t compare_len = std::min(motif.length(), text.length() - suffixArray[mid]);
-            int  cmp =text.compare(suffixArray[mid], compare_len, motif, 0, compare_len); //comparer le motif avec le suffixe de milieu
+// comparaison à partir du caractère k (les k premiers sont déjà connus égaux)
+int SuffixArray::compareSuffixFrom(size_t pos, std::string_view motif, size_t& matched) const {
+    const size_t m = motif.length();
+    const size_t len = std::min(m, textLength - pos);
+    for (size_t i = matched; i < len; ++i) {
+        char c = charAt(pos + i);
+        if (c != motif[i]) {
+            matched = i;
+            return c < motif[i] ? -1 : 1;
+        }
+    }
+    matched = len;
+    return len < m ? -1 : 0; // suffixe plus court que le motif
+}
+
+//get equalRange
+/**
+ * @brief Intervalle [lower, upper) des suffixes dont le motif est préfixe, en une seule descente.
+ *
+ * @par Heuristique mlr (Manber-Myers) :
+ * On conserve llo = lcp(motif, SA[lo]) et lhi = lcp(motif, SA[hi]). Tous les suffixes
+ * compris entre lo et hi partagent au moins min(llo, lhi) caractères avec le motif :
+ * la comparaison au milieu reprend à partir de ce rang au lieu de repartir de 0.
+ *
+ * @par Descente unique :
+ * Tant que le suffixe du milieu n'a pas le motif pour préfixe, les deux bornes
+ * se déplacent de la même façon. Au premier suffixe qui correspond, la recherche
+ * se sépare : borne inférieure dans [lo, mid], borne supérieure dans [mid, hi],
+ * chacune en conservant ses longueurs de préfixe commun.
+ *
+ * Invariants : SA[lo] < motif (SA[0] est la sentinelle '$') et SA[hi] > motif
+ * (hi = n est un suffixe virtuel +∞).
+ */
+std::pair<size_t, size_t> SuffixArray::equalRange(std::string_view motif) const {
+    const size_t n = suffixArray.size();
+    const size_t m = motif.length();
+    if (m == 0 || m > textLength) return {n, n};
 
-        if(cmp >= 0){
-            result = mid; //stocker le resultat
-            right = mid - 1; //chercher dans la partie gauche
-        }else{
-            left = mid + 1; //chercher dans la partie droite
-        }   
+    size_t lo = 0, hi = n;
+    size_t llo = 0, lhi = 0;
 
+    // Table des q-grammes : on démarre dans l'intervalle du q-mer en tête du motif.
+    // SA[table[c] - 1] < motif et SA[table[c + 1]] > motif : les invariants sont respectés.
+    if (prefixLength > 0 && m >= prefixLength) {
+        size_t code = 0;
+        bool valid = true;
+        for (size_t i = 0; i < prefixLength && valid; ++i) {
+            switch (motif[i]) {
+                case 'A': code = code << 2; break;
+                case 'C': code = (code << 2) | 1; break;
+                case 'G': code = (code << 2) | 2; break;
+                case 'T': code = (code << 2) | 3; break;
+                default: valid = false;
+            }
+        }
+        if (valid) {
+            size_t start = prefixTable[code];
+            size_t end = prefixTable[code + 1];
+            if (start == end) return {start, start};
+            lo = start - 1;
+            hi = end;
+        }
     }
-    return result;
-}
 
-//get upperBound
-size_t SuffixArray::upperBound(const std::string& motif) const{
-    size_t  left = 0;
-    size_t  right = suffixArray.size()-1; //-1 pour ne pas calculer le $ a la fin de mon motif
-    size_t  result = suffixArray.size(); //initialiser le resultat a la taille de ma table SA
-        
-        while(left <= right){
-            size_t  mid = left + (right - left) / 2; //calculer le milieu
+    // Phase commune : jusqu'au premier suffixe qui a le motif pour préfixe
+    size_t mid = n;
+    while (hi - lo > 1) {
+        size_t probe = lo + (hi - lo) / 2;
+        size_t matched = std::min(llo, lhi);
+        int cmp = compareSuffixFrom(suffixArray[probe], motif, matched);
+        if (cmp == 0) {
+            mid = probe;
+            break;
+        }
+        if (cmp < 0) {
+            lo = probe;
+            llo = matched;
+        } else {
+            hi = probe;
+            lhi = matched;
+        }
+    }
+    if (mid == n) return {hi, hi}; // motif absent
 
-            // Vérification des limites pour éviter le débordement
-            size_t compare_len = std::min(motif.length(), text.length() - suffixArray[mid]);
-            int  cmp =text.compare(suffixArray[mid], compare_len, motif, 0, compare_len); //comparer le motif avec le suffixe de milieu
-    
-            if(cmp > 0){
-                result = mid; //stocker le resultat
-                right = mid - 1; //chercher dans la partie gauche
-            }else{
-                left = mid + 1; //chercher dans la partie droite
-            }   
-    
+    // Borne inférieure : premier suffixe ≥ motif dans (lo, mid]
+    size_t left = lo, right = mid, lLeft = llo, lRight = m;
+    while (right - left > 1) {
+        size_t probe = left + (right - left) / 2;
+        size_t matched = std::min(lLeft, lRight);
+        if (compareSuffixFrom(suffixArray[probe], motif, matched) < 0) {
+            left = probe;
+            lLeft = matched;
+        } else {
+            right = probe;
+            lRight = matched;
         }
-        return result; 
+    }
+    const size_t lower = right;
+
+    // Borne supérieure : premier suffixe > motif dans (mid, hi]
+    left = mid; right = hi; lLeft = m; lRight = lhi;
+    while (right - left > 1) {
+        size_t probe = left + (right - left) / 2;
+        size_t matched = std::min(lLeft, lRight);
+        if (compareSuffixFrom(suffixArray[probe], motif, matched) <= 0) {
+            left = probe;
+            lLeft = matched;
+        } else {
+            right = probe;
+            lRight = matched;
+        }
+    }
+    return {lower, right};
 }
 
 
@@ -192,29 +755,23 @@ size_t SuffixArray::countOccurrences(const std::string& text) const {
     if (text.empty()) {
         return 0;
     }
-    size_t lower = lowerBound(text);
-    size_t upper = upperBound(text);
+    auto [lower, upper] = equalRange(text);
     return upper - lower;
 }
 
 //fonction getfactor
 std::string SuffixArray::getFactor(size_t i, size_t k) const {
-    if (i + k > text.length() - 1) {
+    if (i + k > textLength - 1) {
         throw std::out_of_range("Index out of range");
     }
-    return text.substr(i, k);
+    return sequence.extract(i, k);
 }
 
 // Fonction pour trouver les occurrences d'un motif dans la chaîne d'origine
 std::vector<size_t> SuffixArray::findOccurrences(const std::string& pattern) const {
     std::vector<size_t> occurrences;
-    const size_t m = pattern.length();
-    if (m == 0 || m > text.length()) return occurrences;
+    auto [lower, upper] = findInterval(pattern);
 
-    // Utilise les bornes existantes pour une recherche O(log n)
-    size_t lower = lowerBound(pattern);
-    size_t upper = upperBound(pattern);
-    
     // Récupère toutes les occurrences
     occurrences.reserve(upper - lower);
     for (size_t i = lower; i < upper; ++i) {
@@ -223,4 +780,12 @@ std::vector<size_t> SuffixArray::findOccurrences(const std::string& pattern) con
 
     return occurrences;
 }
-    
\ No newline at end of file
+    
+
+std::pair<size_t, size_t> SuffixArray::findInterval(std::string_view motif) const {
+    const size_t m = motif.length();
+    if (m == 0 || m > textLength) return {0, 0};
+
+    // Une seule descente accélérée par les préfixes communs (mlr) pour les deux bornes
+    return equalRange(motif);
+}
@@ -0,0 +1,113 @@
+/* ce fichier compare les moteurs de KmerIndex (table des suffixes, index FM, table de hachage)
+ * sur une même référence : temps de construction, taille de l'index et temps de recherche des k-mers.
+ *pour compiler: g++ -O2 -std=c++20 -fopenmp kmer_bench.cpp SuffixArray.cpp FMIndex.cpp KmerHashTable.cpp KmerIndex.cpp IndexArray.cpp IndexFile.cpp MappedFile.cpp PackedSequence.cpp FastaParser.cpp SequenceParser.cpp ReverseComplement.cpp -o kmer_bench
+ *pour executer: ./kmer_bench [reference.fasta=seq1m.fasta] [k=20] [requêtes=200000]
+ *avec le makefile: make test file=kmer_bench.cpp args="seq1m.fasta 20 200000"
+ */
+
+#include "KmerIndex.h"
+#include "FastaParser.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdio>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Taille du fichier d'index, en Mo (mesure de l'empreinte mémoire une fois projeté)
+double indexSizeMb(const KmerIndex& index) {
+    const char* path = "kmer_bench.idx";
+    index.save(path);
+    std::FILE* file = std::fopen(path, "rb");
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    std::remove(path);
+    return size / 1e6;
+}
+
+void benchmark(const std::string& name, const std::string& reference, std::size_t k,
+               IndexEngine engine, const std::vector<std::string>& kmers) {
+    IndexOptions options;
+    options.engine = engine;
+
+    auto start = std::chrono::steady_clock::now();
+    KmerIndex index(reference, k, 1, options);
+    double buildTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::size_t support = 0;
+    for (const auto& kmer : kmers) {
+        support += index.getKmerSupport(kmer);
+    }
+    double countTime = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::size_t found = 0;
+    for (const auto& kmer : kmers) {
+        found += index.findKmerPositions(kmer).size();
+    }
+    double locateTime = secondsSince(start);
+
+    // Même recherche sans allocation : vue sur le k-mer et parcours de l'intervalle
+    start = std::chrono::steady_clock::now();
+    std::size_t visited = 0;
+    for (const auto& kmer : kmers) {
+        index.forEachKmerPosition(kmer, [&visited](std::size_t) { ++visited; });
+    }
+    double intervalTime = secondsSince(start);
+
+    std::cout << std::left << std::setw(18) << name << std::fixed << std::setprecision(3)
+              << " construction " << buildTime << " s"
+              << " | index " << std::setprecision(2) << indexSizeMb(index) << " Mo"
+              << " | comptage " << std::setprecision(1) << countTime * 1e9 / kmers.size() << " ns/k-mer"
+              << " | positions " << locateTime * 1e9 / kmers.size() << " ns/k-mer"
+              << " | intervalle " << intervalTime * 1e9 / kmers.size() << " ns/k-mer"
+              << " (" << support << " / " << found << " / " << visited << ")\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string referenceFile = argc > 1 ? argv[1] : "seq1m.fasta";
+    std::size_t k = argc > 2 ? std::stoul(argv[2]) : 20;
+    std::size_t queries = argc > 3 ? std::stoul(argv[3]) : 200000;
+
+    FastaParser parser(referenceFile);
+    if (!parser.loadFile() || parser.getSequences().empty()) {
+        std::cerr << "Erreur: impossible de lire " << referenceFile << std::endl;
+        return 1;
+    }
+    const std::string& reference = parser.getSequences()[0];
+    if (reference.length() < k) {
+        std::cerr << "Erreur: référence plus courte que k" << std::endl;
+        return 1;
+    }
+
+    // Moitié de k-mers tirés de la référence (présents), moitié aléatoires (le plus souvent absents)
+    std::mt19937 rng(42);
+    std::vector<std::string> kmers;
+    kmers.reserve(queries);
+    for (std::size_t i = 0; i < queries; ++i) {
+        if (i % 2 == 0) {
+            kmers.push_back(reference.substr(rng() % (reference.length() - k + 1), k));
+        } else {
+            std::string kmer(k, 'A');
+            for (auto& c : kmer) c = "ACGT"[rng() % 4];
+            kmers.push_back(kmer);
+        }
+    }
+
+    std::cout << "Référence: " << referenceFile << " (" << reference.length() << " bases), k=" << k
+              << ", " << queries << " requêtes\n";
+    benchmark("table des suffixes", reference, k, IndexEngine::SUFFIX_ARRAY, kmers);
+    benchmark("index FM", reference, k, IndexEngine::FM_INDEX, kmers);
+    benchmark("table de hachage", reference, k, IndexEngine::HASH_TABLE, kmers);
+    return 0;
+}
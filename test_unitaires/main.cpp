@@ -1,13 +1,32 @@
 /* ce fichier est consus pour tester la classe SuffixArray
  * il utilise la classe SuffixArray pour rechercher des motifs dans une séquence d'ADN
- *pour compiler: g++ -std=c++20 main.cpp SuffixArray.cpp -o suffix_array_tester
+ *pour compiler: g++ -std=c++20 main.cpp SuffixArray.cpp FMIndex.cpp KmerHashTable.cpp KmerIndex.cpp ReadMapper.cpp IndexArray.cpp IndexFile.cpp MappedFile.cpp PackedSequence.cpp SequenceParser.cpp ReverseComplement.cpp BandedAligner.cpp MyersEditDistance.cpp SeedChainer.cpp MappingPipeline.cpp SamWriter.cpp FastqScanner.cpp GzipReader.cpp FormatFileDetector.cpp RecordBatch.cpp FastqFileReader.cpp FastaParser.cpp FastaIndex.cpp -lz -o suffix_array_tester
     *pour executer: ./suffix_array_tester
  *
 */
 
 #include <iostream>
 #include "SuffixArray.h"
+#include "KmerIndex.h"
+#include "FMIndex.h"
+#include "ReadMapper.h"
+#include "MappingPipeline.h"
+#include "BandedAligner.h"
+#include "MyersEditDistance.h"
+#include "SeedChainer.h"
+#include "SamWriter.h"
+#include "FastqScanner.h"
+#include "FastqFileRreader.h"
+#include "RecordBatch.h"
+#include "FastaIndex.h"
+#include "FastaParser.h"
+#include "FormatFileDetector.h"
+#include <zlib.h>
 #include <chrono>  
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <random>
 
 int main() {
     try {
@@ -45,7 +64,816 @@ int main() {
         }
         std::cout << std::endl;
 
-        
+        // Validation croisée : SA-IS et doublement parallèle contre l'ancien tri par comparaison
+        const std::vector<std::string> textes = {
+            genome,
+            "TTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTAT",
+            "ACACACACACACACACACACACACACGACACACACACACACA",
+            "A",
+            ""
+        };
+        for (const auto& t : textes) {
+            SuffixArray sais(t, SuffixArray::BuildMethod::SAIS);
+            SuffixArray naif(t, SuffixArray::BuildMethod::NAIVE_SORT);
+            SuffixArray parallele(t, SuffixArray::BuildMethod::PARALLEL_DOUBLING, 4);
+            // table 40 bits forcée : mêmes valeurs que la table 32 bits choisie automatiquement
+            SuffixArray sais40(t, SuffixArray::BuildMethod::SAIS, 0, 5);
+            bool identiques = sais.getSuffixArray() == naif.getSuffixArray() &&
+                              parallele.getSuffixArray() == naif.getSuffixArray() &&
+                              sais40.getSuffixArray() == naif.getSuffixArray() &&
+                              sais.getLcpArray() == naif.getLcpArray();
+            std::cout << "SA-IS / parallèle / tri naïf (n=" << t.length() << ") : "
+                      << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Largeur imposée hors de {4, 5, 8} : refusée
+        {
+            bool refuse = false;
+            try {
+                SuffixArray invalide("ACGT", SuffixArray::BuildMethod::SAIS, 0, 3);
+            } catch (const std::invalid_argument&) {
+                refuse = true;
+            }
+            std::cout << "Largeur de table des suffixes invalide : " << (refuse ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!refuse) return 1;
+        }
+
+        // Recherche accélérée (mlr, descente unique) contre un parcours naïf du texte,
+        // sans puis avec la table des q-grammes
+        SuffixArray saTable(genome);
+        saTable.buildPrefixTable(2);
+        for (const std::string motif : {"ATCG", "CG", "TATA", "GTAC", "A", "CCCC", "ATCGATCG"}) {
+            std::vector<size_t> attendues;
+            for (size_t pos = genome.find(motif); pos != std::string::npos; pos = genome.find(motif, pos + 1)) {
+                attendues.push_back(pos);
+            }
+            std::vector<size_t> trouvees = sa.findOccurrences(motif);
+            std::sort(trouvees.begin(), trouvees.end());
+            std::vector<size_t> trouveesTable = saTable.findOccurrences(motif);
+            std::sort(trouveesTable.begin(), trouveesTable.end());
+            if (trouvees != attendues || trouveesTable != attendues ||
+                sa.countOccurrences(motif) != attendues.size()) {
+                std::cout << "Recherche de " << motif << " : DIFFÉRENTS" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "Recherche mlr / table des q-grammes / parcours naïf : identiques" << std::endl;
+
+        // Index FM (BWT + SA échantillonnée) contre la table des suffixes, bases N comprises
+        {
+            std::string texte = genome + "NNNN" + genome.substr(10, 30) + "N" + genome.substr(0, 17);
+            SuffixArray table(texte);
+            for (unsigned taux : {1u, 3u, 16u}) {
+                FMIndex fm = FMIndex::fromSuffixArray(SuffixArray(texte), taux);
+                for (const std::string motif : {"ATCG", "CG", "TATA", "NN", "GN", "A", "CCCC", "ATCGATCG"}) {
+                    std::vector<size_t> attendues = table.findOccurrences(motif);
+                    std::vector<size_t> trouvees = fm.findOccurrences(motif);
+                    std::sort(attendues.begin(), attendues.end());
+                    std::sort(trouvees.begin(), trouvees.end());
+                    if (trouvees != attendues || fm.countOccurrences(motif) != attendues.size()) {
+                        std::cout << "Index FM (taux " << taux << "), motif " << motif << " : DIFFÉRENTS" << std::endl;
+                        return 1;
+                    }
+                }
+            }
+            std::cout << "Index FM / table des suffixes : identiques" << std::endl;
+        }
+
+        // Table de hachage des k-mers : mêmes positions que la table des suffixes (pas de 1),
+        // seulement les positions multiples du pas sinon
+        {
+            IndexOptions options;
+            options.engine = IndexEngine::HASH_TABLE;
+            for (size_t pas : {1u, 3u}) {
+                KmerIndex table(genome, 5, pas, options);
+                for (const std::string motif : {"ATCGA", "TCGTA", "GTACA", "CCCCC", "ATCGN"}) {
+                    std::vector<size_t> attendues;
+                    for (size_t pos : sa.findOccurrences(motif)) {
+                        if (pos % pas == 0) attendues.push_back(pos);
+                    }
+                    std::sort(attendues.begin(), attendues.end());
+                    if (table.findKmerPositions(motif) != attendues) {
+                        std::cout << "Table de hachage (pas " << pas << "), motif " << motif << " : DIFFÉRENTS" << std::endl;
+                        return 1;
+                    }
+                }
+            }
+            std::cout << "Table de hachage / table des suffixes : identiques" << std::endl;
+        }
+
+        // Mode minimiseurs (w,k) : un read exact de plus de w + k - 1 bases est retrouvé
+        // sur ses deux brins, y compris après sauvegarde / rechargement de l'index
+        {
+            IndexOptions options;
+            options.engine = IndexEngine::HASH_TABLE;
+            options.minimizerWindow = 5;
+            KmerIndex index(genome, 8, 1, options);
+            index.save("test_index_min.idx");
+            ReadMapper mapper(KmerIndex::load("test_index_min.idx"));
+            std::remove("test_index_min.idx");
+
+            std::string read = genome.substr(20, 25);
+            MappingResult direct = mapper.mapRead(read);
+            MappingResult inverse = mapper.mapRead(SequenceParser::getReverseComplement(read));
+            bool identiques = mapper.getIndex().getMinimizerWindow() == 5 &&
+                              direct.referencePos == 20 && direct.strand == Strand::FORWARD &&
+                              inverse.referencePos == 20 && inverse.strand == Strand::REVERSE_COMPLEMENT;
+            std::cout << "Minimiseurs (w=5, k=8) : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Recherche sans allocation (vue sur le read, intervalle de rangs) : mêmes positions
+        // que findKmerPositions pour chaque moteur
+        {
+            for (IndexEngine moteur : {IndexEngine::SUFFIX_ARRAY, IndexEngine::FM_INDEX, IndexEngine::HASH_TABLE}) {
+                IndexOptions options;
+                options.engine = moteur;
+                KmerIndex index(genome, 5, 1, options);
+                std::string_view vue = genome;
+                for (size_t i = 0; i + 5 <= genome.length(); i += 7) {
+                    std::vector<size_t> trouvees;
+                    index.forEachKmerPosition(vue.substr(i, 5), [&trouvees](size_t pos) { trouvees.push_back(pos); });
+                    auto [debut, fin] = index.findKmerInterval(vue.substr(i, 5));
+                    if (trouvees != index.findKmerPositions(genome.substr(i, 5)) || fin - debut != trouvees.size() ||
+                        (fin > debut && index.kmerPositionAt(debut) != trouvees.front())) {
+                        std::cout << "Recherche par intervalle, k-mer " << genome.substr(i, 5) << " : DIFFÉRENTS" << std::endl;
+                        return 1;
+                    }
+                }
+            }
+            std::cout << "Recherche par intervalle / par vecteur : identiques" << std::endl;
+        }
+
+        // Codage glissant : codes des deux brins identiques au codage de chaque k-mer extrait,
+        // et complément inverse vectorisé identique à la table (codes IUPAC compris)
+        {
+            std::string sequence = genome + "acgtNNACGTRYAC" + genome + genome;
+            std::string inverse = SequenceParser::getReverseComplement(sequence);
+            std::string attendu;
+            for (auto it = sequence.rbegin(); it != sequence.rend(); ++it) {
+                char c = *it;
+                switch (c) {
+                    case 'A': c = 'T'; break; case 'T': c = 'A'; break;
+                    case 'C': c = 'G'; break; case 'G': c = 'C'; break;
+                    case 'a': c = 't'; break; case 't': c = 'a'; break;
+                    case 'c': c = 'g'; break; case 'g': c = 'c'; break;
+                    case 'R': c = 'Y'; break; case 'Y': c = 'R'; break;
+                }
+                attendu += c;
+            }
+            bool identiques = inverse == attendu &&
+                SequenceParser::getReverseComplement(genome + genome) == SequenceParser::getReverseComplement(genome + genome + "R").substr(1);
+
+            KmerEncoder encodeur(7);
+            size_t nombre = 0;
+            encodeur.forEach(sequence, [&](size_t i, uint64_t direct, uint64_t complement) {
+                uint64_t code;
+                identiques = identiques && KmerHashTable::encode(std::string_view(sequence).substr(i, 7), code) && code == direct &&
+                             KmerHashTable::encode(std::string_view(inverse).substr(sequence.length() - 7 - i, 7), code) &&
+                             code == complement;
+                ++nombre;
+            });
+            identiques = identiques && nombre == 3 * genome.length() - 10;
+            std::cout << "Codage glissant / complément inverse : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Mapping par bloc : mêmes résultats que mapRead read par read, pour chaque moteur,
+        // en mode minimiseurs, avec des k-mers répétés d'un read à l'autre et un read trop court
+        {
+            ReadBlock bloc;
+            std::vector<std::string> reads;
+            for (size_t i = 0; i < 40; ++i) {
+                std::string read = genome.substr((i * 5) % 30, 15 + i % 15);
+                if (i % 2 == 1) read = SequenceParser::getReverseComplement(read);
+                reads.push_back(read);
+            }
+            reads.push_back("ACGT");
+            reads.push_back(reads[3]);
+            for (const auto& read : reads) bloc.add(read);
+
+            bool identiques = bloc.size() == reads.size() && bloc.read(2) == reads[2];
+            for (IndexEngine moteur : {IndexEngine::SUFFIX_ARRAY, IndexEngine::FM_INDEX, IndexEngine::HASH_TABLE}) {
+                for (size_t fenetre : {0u, 4u}) {
+                    IndexOptions options;
+                    options.engine = moteur;
+                    options.minimizerWindow = fenetre;
+                    ReadMapper mapper(genome, 6, 2, options);
+                    std::vector<MappingResult> resultats = mapper.mapBatch(bloc);
+                    for (size_t i = 0; i < reads.size(); ++i) {
+                        MappingResult attendu = mapper.mapRead(reads[i]);
+                        identiques = identiques && resultats[i].referencePos == attendu.referencePos &&
+                                     resultats[i].strand == attendu.strand &&
+                                     resultats[i].confidence == attendu.confidence &&
+                                     resultats[i].isUnique == attendu.isUnique &&
+                                     resultats[i].cigarString == attendu.cigarString;
+                    }
+                }
+            }
+            std::cout << "Mapping par bloc / mapRead : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Pipeline multithreadé : mêmes résultats que mapRead, dans l'ordre des reads, avec
+        // des petits lots et peu de lots en vol ; une erreur d'écriture est relancée par run()
+        {
+            ReadMapper mapper(genome, 8, 2);
+            std::vector<ReadRecord> reads;
+            for (size_t i = 0; i < 500; ++i) {
+                std::string read = genome.substr((i * 7) % 35, 20);
+                if (i % 3 == 0) read = SequenceParser::getReverseComplement(read);
+                reads.push_back({"@r" + std::to_string(i), read, std::string(20, 'I')});
+            }
+            auto source = [&reads](const std::function<void(ReadRecord&&)>& emit) {
+                for (const auto& read : reads) emit(ReadRecord(read));
+            };
+            MappingPipeline pipeline(mapper, 3, 7, 2);
+            size_t suivant = 0;
+            bool identiques = true;
+            size_t total = pipeline.run(source, [&](const ReadRecord& record, const MappingResult& result) {
+                MappingResult attendu = mapper.mapRead(reads[suivant].sequence);
+                identiques = identiques && record.header == reads[suivant].header &&
+                             result.referencePos == attendu.referencePos && result.strand == attendu.strand;
+                ++suivant;
+            });
+            identiques = identiques && total == reads.size() && suivant == reads.size();
+
+            bool erreurRelancee = false;
+            try {
+                pipeline.run(source, [](const ReadRecord&, const MappingResult&) {
+                    throw std::runtime_error("écriture impossible");
+                });
+            } catch (const std::runtime_error&) {
+                erreurRelancee = true;
+            }
+            identiques = identiques && erreurRelancee;
+            std::cout << "Pipeline multithreadé / mapRead : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Alignement en bande : délétion et insertion retrouvées dans le CIGAR, mêmes
+        // résultats avec et sans AVX2 ; le mapper place un read à indel à la bonne position
+        {
+            std::mt19937 generateur(42);
+            std::string cible(300, 'A');
+            for (char& base : cible) base = "ACGT"[generateur() % 4];
+
+            std::string lu = cible.substr(100, 60);
+            lu.erase(30, 2);
+            BandedAligner aligneur;
+            BandedAligner::Alignment vectorise = aligneur.align(lu, cible, 100);
+            aligneur.setVectorized(false);
+            BandedAligner::Alignment scalaire = aligneur.align(lu, cible, 100);
+            bool identiques = vectorise.targetStart == 100 && vectorise.targetEnd == 160 &&
+                              vectorise.editDistance == 2 && vectorise.score == 58 - 8 &&
+                              vectorise.cigar.find('D') != std::string::npos &&
+                              scalaire.cigar == vectorise.cigar && scalaire.score == vectorise.score;
+
+            // Cible vide (diagonale négative) : alignement vide sur les deux chemins
+            BandedAligner::Alignment videScalaire = aligneur.align(lu, "", -5);
+            aligneur.setVectorized(true);
+            BandedAligner::Alignment videVectorise = aligneur.align(lu, "", -5);
+            aligneur.setVectorized(false);
+            identiques = identiques && videVectorise.score == 0 && videVectorise.cigar.empty() &&
+                         videVectorise.targetStart == 0 && videScalaire.score == 0 &&
+                         videScalaire.cigar.empty() && videScalaire.targetStart == 0;
+
+            std::string insere = cible.substr(150, 60);
+            insere.insert(25, "T");
+            ReadMapper mapper(cible, 8, 2);
+            MappingResult resultat = mapper.mapRead(insere);
+            identiques = identiques && resultat.referencePos == 150 && resultat.strand == Strand::FORWARD &&
+                         resultat.editDistance == 1 && resultat.cigarString.find('I') != std::string::npos;
+
+            // Read trop long pour des scores sur 16 bits : non mappé au lieu d'interrompre le lot,
+            // et son mate est mappé normalement
+            std::string longue;
+            for (int i = 0; i < 40000; ++i) longue += "ACGT"[generateur() % 4];
+            ReadMapper mapperLong(longue, 15, 1);
+            identiques = identiques && !aligneur.canAlign(20000) && aligneur.canAlign(15000);
+            ReadBlock lot;
+            lot.add(longue.substr(1000, 20000));
+            lot.add(longue.substr(30000, 100));
+            std::vector<MappingResult> lus = mapperLong.mapBatch(lot);
+            PairedMappingResult paire = mapperLong.mapPair(longue.substr(1000, 20000),
+                SequenceParser::getReverseComplement(longue.substr(21200, 100)));
+            identiques = identiques && lus.size() == 2 && lus[0].cigarString.empty() &&
+                         lus[1].referencePos == 30000 && paire.mate1.cigarString.empty() &&
+                         paire.mate2.referencePos == 21200 && !paire.properPair;
+            std::cout << "Alignement en bande : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Distance d'édition de Myers (plusieurs blocs de 64 lignes) contre la programmation
+        // dynamique ; le filtre du mapper écarte un read trop éloigné de la référence
+        {
+            std::mt19937 generateur(7);
+            std::string texte(400, 'A');
+            for (char& base : texte) base = "ACGT"[generateur() % 4];
+            auto naive = [](const std::string& motif, const std::string& t) {
+                std::vector<int> precedente(motif.size() + 1), courante(motif.size() + 1);
+                for (size_t i = 0; i <= motif.size(); ++i) precedente[i] = static_cast<int>(i);
+                int meilleure = static_cast<int>(motif.size());
+                for (char c : t) {
+                    courante[0] = 0;
+                    for (size_t i = 1; i <= motif.size(); ++i) {
+                        courante[i] = std::min({precedente[i - 1] + (motif[i - 1] == c ? 0 : 1),
+                                                precedente[i] + 1, courante[i - 1] + 1});
+                    }
+                    meilleure = std::min(meilleure, courante[motif.size()]);
+                    std::swap(precedente, courante);
+                }
+                return meilleure;
+            };
+            bool identiques = true;
+            for (size_t longueur : {20u, 64u, 65u, 150u}) {
+                std::string motif = texte.substr(100, longueur);
+                motif[longueur / 2] = motif[longueur / 2] == 'A' ? 'C' : 'A';
+                motif.erase(longueur / 3, 1);
+                motif.insert(2 * longueur / 3, "G");
+                MyersEditDistance myers(motif);
+                int attendue = naive(motif, texte);
+                identiques = identiques && myers.search(texte, 10) == attendue &&
+                             myers.search(texte, attendue) == attendue &&
+                             myers.search(texte, attendue - 1) == attendue;
+            }
+
+            std::string lu = texte.substr(200, 60);
+            for (size_t i = 5; i < 60; i += 12) lu[i] = lu[i] == 'A' ? 'C' : 'A';
+            ReadMapper mapper(texte, 8, 2);
+            mapper.setMaxEditDistance(6);
+            MappingResult garde = mapper.mapRead(lu);
+            mapper.setMaxEditDistance(2);
+            MappingResult ecarte = mapper.mapRead(lu);
+            identiques = identiques && garde.referencePos == 200 && garde.editDistance == 5 &&
+                         ecarte.cigarString.empty();
+            std::cout << "Distance d'édition de Myers : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Chaînage des graines : tri radix identique au tri par comparaison ; les graines
+        // d'un read à délétion forment une seule chaîne, une graine isolée une autre
+        {
+            std::mt19937 generateur(3);
+            std::vector<Anchor> ancres;
+            for (std::uint32_t i = 0; i < 500; ++i) {
+                ancres.push_back({generateur() % 100000, i, static_cast<std::uint32_t>(generateur() % 2)});
+            }
+            std::vector<Anchor> attendues = ancres;
+            std::stable_sort(attendues.begin(), attendues.end(), [](const Anchor& a, const Anchor& b) {
+                return a.reverse != b.reverse ? a.reverse < b.reverse : a.diagonal < b.diagonal;
+            });
+            SeedChainer::sortByDiagonal(ancres);
+            bool identiques = std::equal(ancres.begin(), ancres.end(), attendues.begin(),
+                [](const Anchor& a, const Anchor& b) { return a.diagonal == b.diagonal && a.readPos == b.readPos; });
+
+            std::vector<Anchor> read;
+            for (std::uint32_t i = 0; i <= 40; i += 2) read.push_back({1000, i, 0});
+            for (std::uint32_t i = 50; i <= 100; i += 2) read.push_back({1006, i, 0});
+            read.push_back({5000, 20, 0});
+            std::vector<Chain> chaines = SeedChainer(10).chain(read);
+            identiques = identiques && chaines.size() == 2 && chaines[0].diagonal == 1000 &&
+                         chaines[0].anchorCount == 47 && chaines[0].score == 10 + 100 - 6 &&
+                         chaines[1].diagonal == 5000 && chaines[1].score == 10;
+            std::cout << "Chaînage des graines : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Paired-end : les deux mates d'un fragment de 300 bases sont appariés ; un mate sans
+        // graine (une base modifiée sur 11) est retrouvé autour de son partenaire
+        {
+            std::mt19937 generateur(11);
+            std::string reference;
+            for (int i = 0; i < 5000; ++i) reference += "ACGT"[generateur() % 4];
+            ReadMapper mapper(reference, 12, 1);
+
+            ReadBlock mates1, mates2;
+            for (std::size_t p = 100; p + 300 <= reference.size(); p += 350) {
+                mates1.add(reference.substr(p, 80));
+                std::string mate2 = SequenceParser::getReverseComplement(reference.substr(p + 220, 80));
+                if (p == 100) {
+                    for (std::size_t j = 4; j < mate2.size(); j += 11) mate2[j] = mate2[j] == 'A' ? 'C' : 'A';
+                }
+                mates2.add(mate2);
+            }
+            std::vector<PairedMappingResult> paires = mapper.mapPairs(mates1, mates2);
+            bool identiques = paires.size() == mates1.size() && paires[0].mate2Rescued;
+            for (std::size_t i = 0; i < paires.size(); ++i) {
+                const std::size_t p = 100 + 350 * i;
+                identiques = identiques && paires[i].properPair && paires[i].insertSize == 300 &&
+                             paires[i].mate1.referencePos == p && paires[i].mate1.strand == Strand::FORWARD &&
+                             paires[i].mate2.referencePos == p + 220 &&
+                             paires[i].mate2.strand == Strand::REVERSE_COMPLEMENT;
+            }
+
+            // Pipeline paired-end : mêmes résultats, dans l'ordre des paires
+            std::vector<PairedMappingResult> pipelinees;
+            MappingPipeline pipeline(mapper, 2, 3);
+            pipeline.runPaired([&](const std::function<void(ReadPair&&)>& emit) {
+                for (std::size_t i = 0; i < mates1.size(); ++i) {
+                    emit(ReadPair{{"", std::string(mates1.read(i)), ""}, {"", std::string(mates2.read(i)), ""}});
+                }
+            }, [&](const ReadPair&, const PairedMappingResult& resultat) { pipelinees.push_back(resultat); });
+            identiques = identiques && pipelinees.size() == paires.size();
+            for (std::size_t i = 0; identiques && i < paires.size(); ++i) {
+                identiques = pipelinees[i].mate2.referencePos == paires[i].mate2.referencePos &&
+                             pipelinees[i].properPair == paires[i].properPair;
+            }
+
+            // Mate plus court que k : ni mappé, ni repêché autour de son partenaire
+            ReadMapper mapper20(reference, 20, 1);
+            PairedMappingResult court = mapper20.mapPair(reference.substr(3000, 100),
+                SequenceParser::getReverseComplement(reference.substr(3288, 12)));
+            identiques = identiques && court.mate1.referencePos == 3000 &&
+                         court.mate2.cigarString.empty() && !court.mate2Rescued &&
+                         !court.properPair;
+
+            // Écart-type de 2000 : la bande de sauvetage est bornée à MAX_RESCUE_BAND ; un mate à
+            // la taille d'insert moyenne est repêché, un mate 1000 bases plus loin ne l'est plus
+            ReadMapper dispersee(reference, 12, 1);
+            dispersee.setInsertSizePrior({300.0, 2000.0, 0});
+            auto sansGraine = [&](std::size_t debut) {
+                std::string mate = SequenceParser::getReverseComplement(reference.substr(debut, 80));
+                for (std::size_t j = 4; j < mate.size(); j += 11) mate[j] = mate[j] == 'A' ? 'C' : 'A';
+                return mate;
+            };
+            PairedMappingResult proche = dispersee.mapPair(reference.substr(1000, 80), sansGraine(1220));
+            PairedMappingResult loin = dispersee.mapPair(reference.substr(1000, 80), sansGraine(2220));
+            identiques = identiques && proche.mate2Rescued && proche.mate2.referencePos == 1220 &&
+                         !loin.mate2Rescued && loin.mate2.cigarString.empty();
+            std::cout << "Mapping paired-end : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Lignes SAM : read reverse (séquence complémentée inversée, qualités inversées),
+        // read non mappé, paire correcte (drapeaux, mate, TLEN)
+        {
+            MappingResult reverse{};
+            reverse.referencePos = 9;
+            reverse.strand = Strand::REVERSE_COMPLEMENT;
+            reverse.cigarString = "4M";
+            reverse.editDistance = 1;
+            reverse.alignmentScore = -1;
+            reverse.isUnique = true;
+            std::string sam;
+            SamWriter::formatRecord(sam, ReadRecord{"@r1 desc", "AACG", "ABCD"}, reverse, "chr1");
+            SamWriter::formatRecord(sam, ReadRecord{">r2", "ACGT", ""}, MappingResult{}, "chr1");
+            bool identiques = sam == "r1\t16\tchr1\t10\t60\t4M\t*\t0\t0\tCGTT\tDCBA\tNM:i:1\tAS:i:-1\n"
+                                     "r2\t4\t*\t0\t0\t*\t*\t0\t0\tACGT\t*\n";
+
+            PairedMappingResult paire{};
+            paire.mate1 = reverse;
+            paire.mate1.referencePos = 300;
+            paire.mate2 = reverse;
+            paire.mate2.strand = Strand::FORWARD;
+            paire.mate2.referencePos = 100;
+            paire.properPair = true;
+            paire.insertSize = 204;
+            sam.clear();
+            SamWriter::formatPair(sam, ReadPair{{"@p/1", "AACG", "ABCD"}, {"@p/2", "ACGT", "ABCD"}}, paire, "chr1");
+            identiques = identiques &&
+                         sam == "p\t83\tchr1\t301\t60\t4M\t=\t101\t-204\tCGTT\tDCBA\tNM:i:1\tAS:i:-1\n"
+                                "p\t163\tchr1\t101\t60\t4M\t=\t301\t204\tACGT\tABCD\tNM:i:1\tAS:i:-1\n";
+            std::cout << "Sortie SAM : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Lecture FASTQ sans copie : lignes ignorées avant '@', fin de ligne CRLF, dernier
+        // enregistrement sans '\n' final ; un tampon coupé s'arrête au début de l'enregistrement incomplet
+        {
+            const std::string contenu = "ligne ignorée\n@r1 desc\nACGT\n+\nIIII\n@r2\r\nGGCC\r\n+\r\nABCD\r\n@r3\nTT\n+\n!!";
+            {
+                std::FILE* fichier = std::fopen("test_scanner.fastq", "wb");
+                std::fwrite(contenu.data(), 1, contenu.size(), fichier);
+                std::fclose(fichier);
+            }
+            std::vector<std::string> lus;
+            std::size_t nombre = FastqScanner("test_scanner.fastq").forEachRecord(
+                [&](std::string_view header, std::string_view sequence, std::string_view quality) {
+                    lus.push_back(std::string(header) + "|" + std::string(sequence) + "|" + std::string(quality));
+                });
+            std::remove("test_scanner.fastq");
+            bool identiques = nombre == 3 &&
+                              lus == std::vector<std::string>{"@r1 desc|ACGT|IIII", "@r2|GGCC|ABCD", "@r3|TT|!!"};
+
+            std::size_t complets = 0;
+            auto compter = [&](std::string_view, std::string_view, std::string_view) { ++complets; };
+            const char* debut = contenu.data();
+            const char* arret = FastqScanner::scanRecords(debut, debut + contenu.find("@r3") + 5, false, compter);
+            identiques = identiques && complets == 2 && arret == debut + contenu.find("@r3");
+            std::cout << "Lecture FASTQ sans copie : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Lecture FASTQ en tranches parallèles : petites tranches pour que les coupures tombent
+        // partout, y compris sur des lignes de qualités qui commencent par '@' ou '+'
+        {
+            std::mt19937 generateur(21);
+            std::string contenu;
+            std::vector<std::string> attendus;
+            for (int i = 0; i < 300; ++i) {
+                std::string sequence, qualite;
+                for (int j = 0; j < 5 + i % 17; ++j) {
+                    sequence += "ACGT"[generateur() % 4];
+                    qualite += "@+I#5"[generateur() % 5];
+                }
+                const std::string header = "@r" + std::to_string(i);
+                contenu += header + "\n" + sequence + (i % 3 == 0 ? "\n+r" + std::to_string(i) + "\n" : "\n+\n") + qualite + "\n";
+                attendus.push_back(header + "|" + sequence + "|" + qualite);
+            }
+            {
+                std::FILE* fichier = std::fopen("test_tranches.fastq", "wb");
+                std::fwrite(contenu.data(), 1, contenu.size(), fichier);
+                std::fclose(fichier);
+            }
+            bool identiques = true;
+            for (std::size_t tranche : {std::size_t(7), std::size_t(61), std::size_t(1000), contenu.size() * 2}) {
+                std::vector<std::string> lus(attendus.size());
+                std::size_t nombre = FastqScanner("test_tranches.fastq").forEachRecordParallel(
+                    [&](std::size_t rang, std::string_view header, std::string_view sequence, std::string_view quality) {
+                        if (rang < lus.size()) {
+                            lus[rang] = std::string(header) + "|" + std::string(sequence) + "|" + std::string(quality);
+                        }
+                    }, 4, tranche);
+                identiques = identiques && nombre == attendus.size() && lus == attendus;
+            }
+            std::remove("test_tranches.fastq");
+            std::cout << "Lecture FASTQ en tranches parallèles : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Entrée compressée : gzip en deux membres concaténés et BGZF (blocs écrits à la main,
+        // deflate brut + CRC32) relus comme le fichier d'origine
+        {
+            std::string fastq;
+            for (int i = 0; i < 2000; ++i) {
+                fastq += "@r" + std::to_string(i) + "\nACGTTGCA" + std::to_string(i % 7) + "\n+\nIIIIIIIII\n";
+            }
+            {
+                gzFile gz = gzopen("test_gzip.fastq.gz", "wb");
+                gzwrite(gz, fastq.data(), static_cast<unsigned>(fastq.size() / 2));
+                gzclose(gz);
+                gz = gzopen("test_gzip.fastq.gz", "ab");
+                gzwrite(gz, fastq.data() + fastq.size() / 2, static_cast<unsigned>(fastq.size() - fastq.size() / 2));
+                gzclose(gz);
+            }
+            {
+                std::FILE* fichier = std::fopen("test_bgzf.fastq.gz", "wb");
+                auto ecrireBloc = [&](const char* donnees, std::size_t taille) {
+                    std::vector<unsigned char> compresse(compressBound(static_cast<uLong>(taille)) + 64);
+                    z_stream flux{};
+                    deflateInit2(&flux, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+                    flux.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(donnees));
+                    flux.avail_in = static_cast<uInt>(taille);
+                    flux.next_out = compresse.data();
+                    flux.avail_out = static_cast<uInt>(compresse.size());
+                    deflate(&flux, Z_FINISH);
+                    const std::size_t longueur = flux.total_out;
+                    deflateEnd(&flux);
+                    const std::size_t bloc = longueur + 25; // BSIZE : taille totale du bloc - 1
+                    const uLong crc = crc32(0L, reinterpret_cast<const unsigned char*>(donnees), static_cast<uInt>(taille));
+                    const unsigned char entete[18] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0,
+                                                      static_cast<unsigned char>(bloc & 0xff),
+                                                      static_cast<unsigned char>(bloc >> 8)};
+                    unsigned char fin[8];
+                    for (int octet = 0; octet < 4; ++octet) {
+                        fin[octet] = static_cast<unsigned char>(crc >> (8 * octet));
+                        fin[4 + octet] = static_cast<unsigned char>(taille >> (8 * octet));
+                    }
+                    std::fwrite(entete, 1, sizeof(entete), fichier);
+                    std::fwrite(compresse.data(), 1, longueur, fichier);
+                    std::fwrite(fin, 1, sizeof(fin), fichier);
+                };
+                for (std::size_t debut = 0; debut < fastq.size(); debut += 5000) {
+                    ecrireBloc(fastq.data() + debut, std::min<std::size_t>(5000, fastq.size() - debut));
+                }
+                ecrireBloc("", 0); // bloc de fin de fichier
+                std::fclose(fichier);
+            }
+
+            bool identiques = FormatFileDetector::detectCompression("test_gzip.fastq.gz") == FormatFileDetector::GZIP &&
+                              FormatFileDetector::detectCompression("test_bgzf.fastq.gz") == FormatFileDetector::BGZF &&
+                              FormatFileDetector::detect("test_bgzf.fastq.gz") == FormatFileDetector::FASTQ;
+            for (const char* nom : {"test_gzip.fastq.gz", "test_bgzf.fastq.gz"}) {
+                std::string relu;
+                FastqScanner(nom, 3).forEachRecord([&](std::string_view h, std::string_view sq, std::string_view q) {
+                    relu.append(h).append("\n").append(sq).append("\n+\n").append(q).append("\n");
+                });
+                std::string ligne, lignes;
+                InputFile flux(nom, 2);
+                while (std::getline(flux, ligne)) lignes += ligne + "\n";
+                identiques = identiques && relu == fastq && lignes == fastq;
+            }
+            std::remove("test_gzip.fastq.gz");
+            std::remove("test_bgzf.fastq.gz");
+            std::cout << "Lecture gzip / BGZF : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Lots en colonnes : lus dans un fichier FASTQ, mappés par le pipeline dans l'ordre,
+        // rendus à la réserve et réutilisés (le nombre de lots alloués reste borné)
+        {
+            ReadMapper mapper(genome, 8, 2);
+            std::string contenu;
+            std::vector<std::string> sequences;
+            for (size_t i = 0; i < 300; ++i) {
+                std::string read = genome.substr((i * 7) % 35, 20);
+                if (i % 3 == 0) read = SequenceParser::getReverseComplement(read);
+                contenu += "@b" + std::to_string(i) + "\n" + read + "\n+\n" + std::string(20, 'I') + "\n";
+                sequences.push_back(read);
+            }
+            {
+                std::FILE* fichier = std::fopen("test_lots.fastq", "wb");
+                std::fwrite(contenu.data(), 1, contenu.size(), fichier);
+                std::fclose(fichier);
+            }
+            RecordBatchPool reserve(7);
+            MappingPipeline::BatchSource source = [&](const std::function<void(std::unique_ptr<RecordBatch>&&)>& emit) {
+                FastqFileReader lecteur("test_lots.fastq");
+                lecteur.forEachBatch(reserve, emit);
+            };
+            MappingPipeline pipeline(mapper, 3, 7, 2);
+            size_t suivant = 0;
+            bool identiques = true;
+            size_t total = pipeline.runRecordBatches(source, reserve,
+                [&](const RecordBatch& lot, const std::vector<MappingResult>& resultats) {
+                    identiques = identiques && lot.size() <= 7 && resultats.size() == lot.size();
+                    for (size_t i = 0; identiques && i < lot.size(); ++i, ++suivant) {
+                        MappingResult attendu = mapper.mapRead(sequences[suivant]);
+                        identiques = lot.header(i) == "@b" + std::to_string(suivant) &&
+                                     lot.sequence(i) == sequences[suivant] && lot.quality(i) == std::string(20, 'I') &&
+                                     resultats[i].referencePos == attendu.referencePos &&
+                                     resultats[i].strand == attendu.strand;
+                    }
+                });
+            std::remove("test_lots.fastq");
+            // 300 reads en lots de 7 : 43 lots, mais au plus 2 en vol + 1 en lecture + 1 en écriture
+            identiques = identiques && total == sequences.size() && suivant == sequences.size() &&
+                         reserve.getAllocatedCount() <= 5;
+            std::cout << "Lots d'enregistrements réutilisés : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Index .fai : géométrie des lignes (LF, CRLF, séquence vide, ligne vide après l'en-tête),
+        // relecture du .fai et extraction de régions comparée aux séquences complètes ; lignes
+        // irrégulières refusées
+        {
+            const std::string chr1 = genome + genome.substr(0, 13);
+            std::string contenu = ">chr1 description\n";
+            for (size_t pos = 0; pos < chr1.size(); pos += 10) contenu += chr1.substr(pos, 10) + "\n";
+            contenu += ">vide\n>chr2\r\nACGTA\r\nTT\r\n";
+            {
+                std::FILE* fichier = std::fopen("test_fai.fasta", "wb");
+                std::fwrite(contenu.data(), 1, contenu.size(), fichier);
+                std::fclose(fichier);
+            }
+            FastaParser parser("test_fai.fasta");
+            parser.writeIndex();
+            const FastaIndex relu = FastaIndex::load("test_fai.fasta.fai");
+            const FastaIndexEntry& premiere = relu.find("chr1");
+            const FastaIndexEntry& derniere = relu.find("chr2");
+            bool identiques = relu.getEntries().size() == 3 && premiere.length == chr1.size() &&
+                              premiere.offset == 18 && premiere.lineBases == 10 && premiere.lineWidth == 11 &&
+                              relu.find("vide").length == 0 && derniere.lineBases == 5 && derniere.lineWidth == 7;
+            for (size_t debut = 0; debut < chr1.size(); debut += 3) {
+                for (size_t longueur : {0u, 1u, 9u, 10u, 11u, 25u}) {
+                    identiques = identiques && parser.fetch("chr1", debut, debut + longueur) == chr1.substr(debut, longueur);
+                }
+            }
+            identiques = identiques && parser.fetch("chr2", 0, 100) == "ACGTATT" && parser.fetch("chr2", 4, 6) == "AT" &&
+                         parser.fetch("vide", 0, 10).empty();
+            std::remove("test_fai.fasta.fai");
+
+            // Ligne vide entre l'en-tête et la première ligne de bases
+            {
+                std::FILE* fichier = std::fopen("test_fai.fasta", "wb");
+                std::fputs(">x\n\nACGT\nAC\n", fichier);
+                std::fclose(fichier);
+            }
+            const FastaIndex espace = FastaIndex::build("test_fai.fasta");
+            identiques = identiques && espace.find("x").offset == 4 && espace.find("x").length == 6 &&
+                         FastaParser("test_fai.fasta").fetch("x", 0, 6) == "ACGTAC";
+
+            {
+                std::FILE* fichier = std::fopen("test_fai.fasta", "wb");
+                std::fputs(">irregulier\nACGT\nAC\nACGT\n", fichier);
+                std::fclose(fichier);
+            }
+            bool refuse = false;
+            try {
+                FastaIndex::build("test_fai.fasta");
+            } catch (const std::runtime_error&) {
+                refuse = true;
+            }
+            std::remove("test_fai.fasta");
+            std::remove("test_fai.fasta.fai");
+            identiques = identiques && refuse;
+            std::cout << "Index .fai / extraction de régions : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Séquence compactée sur 2 bits : les bases non-ACGT sont relues comme 'N'
+        {
+            PackedSequence compacte("ACGTNNacgtRYACGTACGTACGTACGTACGTACGTAC");
+            bool identiques = compacte.extract(0, compacte.length()) ==
+                              "ACGTNNACGTNNACGTACGTACGTACGTACGTACGTAC";
+            std::cout << "Séquence compactée : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Sauvegarde puis rechargement (mmap) de l'index : mêmes tables, mêmes résultats
+        {
+            KmerIndex index(genome, 5, 1);
+            index.save("test_index.idx");
+            KmerIndex charge = KmerIndex::load("test_index.idx");
+            bool identiques = charge.getReference().extract(0, genome.length()) == genome &&
+                              charge.getKmerSize() == 5 &&
+                              charge.findKmerPositions(pattern) == index.findKmerPositions(pattern);
+            std::cout << "Index sauvegardé / rechargé : "
+                      << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            std::remove("test_index.idx");
+            if (!identiques) return 1;
+        }
+
+        // Même chose avec un index FM
+        {
+            IndexOptions options;
+            options.engine = IndexEngine::FM_INDEX;
+            KmerIndex index(genome, 5, 1, options);
+            index.save("test_index_fm.idx");
+            KmerIndex charge = KmerIndex::load("test_index_fm.idx");
+            std::vector<size_t> attendues = index.findKmerPositions(pattern);
+            std::vector<size_t> trouvees = charge.findKmerPositions(pattern);
+            std::sort(attendues.begin(), attendues.end());
+            std::sort(trouvees.begin(), trouvees.end());
+            bool identiques = charge.getEngine() == IndexEngine::FM_INDEX &&
+                              charge.getReference().extract(0, genome.length()) == genome &&
+                              !trouvees.empty() && trouvees == attendues;
+            std::cout << "Index FM sauvegardé / rechargé : "
+                      << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            std::remove("test_index_fm.idx");
+            if (!identiques) return 1;
+        }
+
+        // Graines répétées : masque des k-mers de plus de 2 occurrences (sur chaque structure,
+        // conservé par la sauvegarde) et limite d'occurrences vérifiée avant la localisation
+        for (IndexEngine moteur : {IndexEngine::SUFFIX_ARRAY, IndexEngine::FM_INDEX, IndexEngine::HASH_TABLE}) {
+            IndexOptions options;
+            options.engine = moteur;
+            options.maskThreshold = 2;
+            KmerIndex index(genome, 4, 1, options);
+            index.save("test_index_masque.idx");
+            KmerIndex charge = KmerIndex::load("test_index_masque.idx");
+            std::remove("test_index_masque.idx");
+
+            bool identiques = index.getMaskedKmerCount() > 0 &&
+                              charge.getMaskedKmerCount() == index.getMaskedKmerCount();
+            for (size_t i = 0; i + 4 <= genome.length(); ++i) {
+                std::string kmer = genome.substr(i, 4);
+                std::uint64_t code;
+                KmerHashTable::encode(kmer, code);
+                const size_t support = index.getKmerSupport(kmer);
+                size_t appels = 0;
+                bool retenu = charge.forEachKmerPosition(code, [&appels](size_t) { ++appels; });
+                identiques = identiques && charge.isMasked(code) == (support > 2) &&
+                             retenu == (support <= 2) && appels == (retenu ? support : 0);
+                // Limite à une occurrence : les k-mers répétés sont ignorés sans callback
+                appels = 0;
+                retenu = index.forEachKmerPosition(std::string_view(kmer), [&appels](size_t) { ++appels; }, 1);
+                identiques = identiques && retenu == (support <= 1) && appels == (retenu ? support : 0);
+            }
+            std::cout << "Masque des k-mers fréquents : " << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
+        // Table de hachage de pas 3 : un k-mer planté 30 fois n'a que 10 positions indexées,
+        // mais le seuil porte sur les occurrences estimées (10 × 3), comme avec la table SA
+        {
+            std::mt19937 generateur(5);
+            std::string texte;
+            for (int i = 0; i < 2000; ++i) texte += "ACGT"[generateur() % 4];
+            for (size_t i = 0; i < 30; ++i) texte.replace(100 + 37 * i, 8, "GATTACAG");
+            std::uint64_t repete, unique;
+            KmerHashTable::encode("GATTACAG", repete);
+            KmerHashTable::encode(texte.substr(1500, 8), unique);
+            bool identiques = true;
+            for (IndexEngine moteur : {IndexEngine::SUFFIX_ARRAY, IndexEngine::HASH_TABLE}) {
+                IndexOptions options;
+                options.engine = moteur;
+                options.maskThreshold = 20;
+                KmerIndex index(texte, 8, 3, options);
+                size_t appels = 0;
+                identiques = identiques && index.isMasked(repete) && !index.isMasked(unique) &&
+                             !index.forEachKmerPosition(std::string_view("GATTACAG"), [&appels](size_t) { ++appels; }, 20) &&
+                             index.forEachKmerPosition(std::string_view("GATTACAG"), [&appels](size_t) { ++appels; }, 40) &&
+                             appels == (moteur == IndexEngine::HASH_TABLE ? 10u : 30u);
+            }
+            std::cout << "Masque des k-mers fréquents (table de hachage échantillonnée) : "
+                      << (identiques ? "identiques" : "DIFFÉRENTS") << std::endl;
+            if (!identiques) return 1;
+        }
+
 
     } catch (const std::exception& e) {
         std::cerr << "Erreur: " << e.what() << std::endl;
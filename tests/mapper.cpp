@@ -2,14 +2,41 @@
  * sur une référence génomique en utilisant un algorithme de k-mer.
  * Il inclut la gestion des fichiers FASTA et FASTQ, ainsi que l'analyse des résultats.
  * pour compiler ce code, utilisez la commande suivante :
- * g++ -std=c++20 -o mapper mapper.cpp ReadMapper.cpp KmerIndex.cpp SuffixArray.cpp FastqFileReader.cpp FastaParser.cpp SequenceParser.cpp FormatFileDetector.cpp
+ * g++ -std=c++20 -fopenmp -o mapper mapper.cpp ReadMapper.cpp KmerIndex.cpp SuffixArray.cpp FMIndex.cpp KmerHashTable.cpp IndexArray.cpp IndexFile.cpp MappedFile.cpp PackedSequence.cpp FastqFileReader.cpp FastaParser.cpp SequenceParser.cpp FormatFileDetector.cpp ReverseComplement.cpp BandedAligner.cpp MyersEditDistance.cpp SeedChainer.cpp MappingPipeline.cpp SamWriter.cpp FastqScanner.cpp GzipReader.cpp RecordBatch.cpp FastaIndex.cpp -lz
  * pour exécuter le code, utilisez la commande suivante :
- * ./mapper reference.fasta reads.fastq [k=21] [step=1]
+ * ./mapper reference.fasta reads.fastq [k=21] [step=1] [threads=1] [index=sa] [w=0] [max_ed=-1] [max_occ=0] [sam]
+ * la référence et les reads peuvent être compressés (.gz, gzip ou BGZF)
+ * les reads sont mappés par threads threads (résultats affichés dans l'ordre des reads) ;
+ * la table des suffixes est toujours construite par SA-IS (mémoire ~5 octets par base)
+ * index=fm remplace la table des suffixes par un index FM (mémoire ~6 fois plus faible),
+ * index=hash par une table de hachage des k-mers (k ≤ 32, recherche en O(1))
+ * w > 0 n'utilise que les (w,k)-minimiseurs des reads (et de la référence avec index=hash)
+ * max_ed ≥ 0 écarte les candidats à plus de max_ed éditions du read (-1 : pas de filtre)
+ * max_occ > 0 ignore les graines de plus de max_occ occurrences et masque ces k-mers dans
+ * l'index construit (0 : pas de limite)
+ * sam : écrit les alignements au format SAM dans ce fichier ("-" : sortie standard)
+ * au lieu du compte rendu lisible read par read
+ *
+ * pour éviter de reconstruire l'index à chaque exécution, on peut le sauvegarder une fois :
+ * ./mapper build-index reference.fasta reference.idx [k=21] [step=1] [threads=1] [index=sa] [w=0] [max_occ=0] [sa_build=sais]
+ * sa_build=doubling construit la table des suffixes par doublement de préfixe sur threads threads :
+ * plus rapide sur plusieurs cœurs, mais ~40 octets par base pendant la construction
+ * puis le passer à la place de la référence (k et step sont alors lus dans l'index) :
+ * ./mapper reference.idx reads.fastq
+ *
+ * index .fai de la référence (compatible samtools) et extraction de régions sans charger le fichier :
+ * ./mapper faidx reference.fasta [chr1:1001-2000]...
+ *
+ * reads paired-end (fichiers R1 et R2 lus au même pas, orientation FR) :
+ * ./mapper paired reference.(fasta|idx) reads_R1.fastq reads_R2.fastq [k=21] [step=1] [threads=1] [index=sa] [w=0] [max_ed=-1] [max_occ=0] [sam]
 */
 #include "ReadMapper.h"
+#include "MappingPipeline.h"
 #include "FastqFileRreader.h"
 #include "FastaParser.h"
 #include "FormatFileDetector.h"
+#include "IndexFile.h"
+#include "SamWriter.h"
 #include <iostream>
 #include <iomanip>
 #include <unordered_map>
@@ -51,69 +78,325 @@ void analyzeMapping(const MappingResult& result, const std::string& readId) {
     std::cout << "Mapping unique: " << (result.isUnique ? "Oui" : "Non") << "\n";
 }
 
-void processFile(const std::string& refFile, const std::string& readFile, int k, int step) {
-    try {
-        // Chargement référence
-        FastaParser refParser(refFile);
-        if (!refParser.loadFile() || !refParser.validate()) {
-            throw std::runtime_error("Erreur référence FASTA");
+void analyzePair(const PairedMappingResult& result, const std::string& readId) {
+    analyzeMapping(result.mate1, readId + "/1");
+    analyzeMapping(result.mate2, readId + "/2");
+    std::cout << "Paire correcte: " << (result.properPair ? "Oui" : "Non");
+    if (result.properPair) {
+        std::cout << " | Taille d'insert: " << result.insertSize;
+    }
+    if (result.mate1Rescued || result.mate2Rescued) {
+        std::cout << " | Mate sauvé: " << (result.mate1Rescued ? "/1" : "/2");
+    }
+    std::cout << "\n";
+}
+
+// Première séquence du FASTA ; name reçoit son nom (en-tête jusqu'au premier blanc)
+std::string loadReference(const std::string& refFile, std::string* name = nullptr) {
+    FastaParser refParser(refFile);
+    // FASTA non compressé à lignes régulières : seule la première séquence est lue, à sa
+    // position dans le fichier (index .fai). Sinon, ou si elle contient autre chose que des
+    // nucléotides, lecture complète et validation comme avant
+    if (FormatFileDetector::detectCompression(refFile) == FormatFileDetector::NONE) {
+        try {
+            const FastaIndex& index = refParser.loadIndex();
+            if (!index.getEntries().empty()) {
+                const FastaIndexEntry& entry = index.getEntries()[0];
+                std::string sequence = refParser.fetch(entry.name, 0, entry.length);
+                if (!sequence.empty() &&
+                    sequence.find_first_not_of("ACGTURYKMSWBDHVNacgturykmswbdhvn") == std::string::npos) {
+                    if (name != nullptr) *name = entry.name;
+                    return sequence;
+                }
+            }
+        } catch (const std::runtime_error&) {
         }
-        std::string reference = refParser.getSequences()[0];
-        
+    }
+    if (!refParser.loadFile() || !refParser.validate()) {
+        throw std::runtime_error("Erreur référence FASTA");
+    }
+    if (name != nullptr) {
+        *name = std::string(SamWriter::readName(refParser.getHeaders()[0]));
+    }
+    return refParser.getSequences()[0];
+}
+
+// buildMethod : SA-IS par défaut ; le doublement de préfixe (gourmand en mémoire) n'est
+// utilisé que sur demande explicite de build-index, jamais à cause du nombre de threads
+IndexOptions makeIndexOptions(int threads, const std::string& engine, int window, int maxOccurrences,
+                              SuffixArray::BuildMethod buildMethod = SuffixArray::BuildMethod::SAIS) {
+    IndexOptions options;
+    options.minimizerWindow = static_cast<std::size_t>(window);
+    options.maskThreshold = static_cast<std::size_t>(maxOccurrences);
+    options.numThreads = threads;
+    options.buildMethod = buildMethod;
+    options.engine = engine == "fm"   ? IndexEngine::FM_INDEX
+                   : engine == "hash" ? IndexEngine::HASH_TABLE
+                                      : IndexEngine::SUFFIX_ARRAY;
+    return options;
+}
+
+// Index sauvegardé (build-index) : projeté en mémoire ; sinon construit depuis le FASTA.
+// referenceName : nom de la séquence (sans FASTA, nom du fichier d'index sans extension)
+ReadMapper createMapper(const std::string& refFile, int k, int step, int threads,
+                        const std::string& engine, int window, int maxOccurrences,
+                        std::string& referenceName, std::ostream& log) {
+    if (IndexFile::isIndexFile(refFile)) {
+        KmerIndex index = KmerIndex::load(refFile);
+        const std::size_t slash = refFile.find_last_of('/');
+        referenceName = refFile.substr(slash == std::string::npos ? 0 : slash + 1);
+        referenceName = referenceName.substr(0, referenceName.find_last_of('.'));
+        log << "Index chargé: k=" << index.getKmerSize()
+                  << ", pas=" << index.getStepSize()
+                  << (index.getEngine() == IndexEngine::FM_INDEX     ? " (index FM)"
+                      : index.getEngine() == IndexEngine::HASH_TABLE ? " (table de hachage)"
+                                                                     : "")
+                  << ", k-mers masqués=" << index.getMaskedKmerCount() << "\n";
+        return ReadMapper(std::move(index));
+    }
+    std::string reference = loadReference(refFile, &referenceName);
+    return ReadMapper(reference, k, step, makeIndexOptions(threads, engine, window, maxOccurrences));
+}
+
+int buildIndex(const std::string& refFile, const std::string& indexFile, int k, int step, int threads,
+               const std::string& engine, int window, int maxOccurrences,
+               SuffixArray::BuildMethod buildMethod) {
+    try {
+        std::string reference = loadReference(refFile);
+        KmerIndex index(reference, k, step, makeIndexOptions(threads, engine, window, maxOccurrences, buildMethod));
+        index.save(indexFile);
+        std::cout << "Index écrit dans " << indexFile << " (" << reference.length() << " bases, "
+                  << index.getMaskedKmerCount() << " k-mers masqués)\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+void processFile(const std::string& refFile, const std::string& readFile, int k, int step, int threads,
+                 const std::string& engine, int window, int maxEditDistance, int maxOccurrences,
+                 const std::string& samFile, std::ostream& log) {
+    try {
         // Initialisation mapper
-        ReadMapper mapper(reference, k, step);
+        std::string referenceName;
+        ReadMapper mapper = createMapper(refFile, k, step, threads, engine, window, maxOccurrences,
+                                         referenceName, log);
+        mapper.setMaxEditDistance(maxEditDistance);
+        mapper.setMaxOccurrences(static_cast<std::size_t>(maxOccurrences));
         
         // Détection format reads
         FormatFileDetector detector;
         auto format = detector.detect(readFile);
-        
+
+        // Lecture des reads par le thread lecteur du pipeline, en lots réutilisés
+        RecordBatchPool pool(MappingPipeline::DEFAULT_BATCH_SIZE);
+        MappingPipeline::BatchSource source;
         if (format == FormatFileDetector::FASTQ) {
-            FastqFileReader reader(readFile);
-            reader.processSequences([&](const std::string& header, 
-                                      const std::string& seq, 
-                                      const std::string& qual) {
-                auto result = mapper.mapRead(seq);
-                analyzeMapping(result, header.substr(0, header.find(' ')));
-            });
+            source = [&readFile, &pool, threads](const std::function<void(std::unique_ptr<RecordBatch>&&)>& emit) {
+                FastqFileReader reader(readFile);
+                reader.setDecompressionThreads(static_cast<unsigned>(threads));
+                reader.forEachBatch(pool, emit);
+            };
         } else if (format == FormatFileDetector::FASTA) {
-            FastaParser parser(readFile);
-            parser.processSequences([&](const std::string& header, 
-                                       const std::string& seq) {
-                auto result = mapper.mapRead(seq);
-                analyzeMapping(result, header.substr(0, header.find(' ')));
-            });
+            source = [&readFile, &pool](const std::function<void(std::unique_ptr<RecordBatch>&&)>& emit) {
+                FastaParser parser(readFile);
+                parser.forEachBatch(pool, emit);
+            };
         } else {
             throw std::runtime_error("Format de fichier non supporté");
         }
+
+        // threads workers mappent les lots ; les résultats sont affichés dans l'ordre des reads
+        MappingPipeline pipeline(mapper, static_cast<unsigned>(threads));
+        if (samFile.empty()) {
+            pipeline.runRecordBatches(source, pool,
+                [](const RecordBatch& batch, const std::vector<MappingResult>& results) {
+                    for (std::size_t i = 0; i < batch.size(); ++i) {
+                        const std::string_view header = batch.header(i);
+                        analyzeMapping(results[i], std::string(header.substr(0, header.find(' '))));
+                    }
+                });
+            return;
+        }
+
+        // SAM : les workers formatent leur lot, le thread appelant écrit les blocs
+        SamWriter writer(samFile);
+        writer.writeHeader({{referenceName, mapper.getIndex().getReference().length()}});
+        pipeline.runRecordBatchesFormatted(source, pool,
+            [&referenceName](const RecordBatch& batch, const std::vector<MappingResult>& results, std::string& out) {
+                for (std::size_t i = 0; i < batch.size(); ++i) {
+                    SamWriter::formatRecord(out, batch, i, results[i], referenceName);
+                }
+            },
+            [&writer](std::string_view block) { writer.writeBlock(block); });
+        writer.flush();
     } catch (const std::exception& e) {
         std::cerr << "Erreur: " << e.what() << std::endl;
     }
 }
 
+// Mode paired-end : les deux fichiers FASTQ sont lus au même pas, une paire à la fois
+void processPairedFiles(const std::string& refFile, const std::string& mates1File,
+                        const std::string& mates2File, int k, int step, int threads,
+                        const std::string& engine, int window, int maxEditDistance, int maxOccurrences,
+                        const std::string& samFile, std::ostream& log) {
+    try {
+        std::string referenceName;
+        ReadMapper mapper = createMapper(refFile, k, step, threads, engine, window, maxOccurrences,
+                                         referenceName, log);
+        mapper.setMaxEditDistance(maxEditDistance);
+        mapper.setMaxOccurrences(static_cast<std::size_t>(maxOccurrences));
+
+        FormatFileDetector detector;
+        if (detector.detect(mates1File) != FormatFileDetector::FASTQ ||
+            detector.detect(mates2File) != FormatFileDetector::FASTQ) {
+            throw std::runtime_error("Le mode paired-end attend deux fichiers FASTQ");
+        }
+
+        MappingPipeline::PairSource source = [&](const std::function<void(ReadPair&&)>& emit) {
+            FastqFileReader reader1(mates1File);
+            FastqFileReader reader2(mates2File);
+            reader1.setDecompressionThreads(static_cast<unsigned>(threads));
+            reader2.setDecompressionThreads(static_cast<unsigned>(threads));
+            ReadPair pair;
+            for (;;) {
+                bool has1 = reader1.nextRecord(pair.mate1.header, pair.mate1.sequence, pair.mate1.quality);
+                bool has2 = reader2.nextRecord(pair.mate2.header, pair.mate2.sequence, pair.mate2.quality);
+                if (has1 != has2) {
+                    throw std::runtime_error("Les fichiers R1 et R2 n'ont pas le même nombre de reads");
+                }
+                if (!has1) break;
+                emit(std::move(pair));
+            }
+        };
+
+        MappingPipeline pipeline(mapper, static_cast<unsigned>(threads));
+        if (samFile.empty()) {
+            pipeline.runPaired(source, [](const ReadPair& pair, const PairedMappingResult& result) {
+                analyzePair(result, pair.mate1.header.substr(0, pair.mate1.header.find(' ')));
+            });
+            return;
+        }
+
+        SamWriter writer(samFile);
+        writer.writeHeader({{referenceName, mapper.getIndex().getReference().length()}});
+        pipeline.runPairedFormatted(source,
+            [&referenceName](const ReadPair& pair, const PairedMappingResult& result, std::string& out) {
+                SamWriter::formatPair(out, pair, result, referenceName);
+            },
+            [&writer](std::string_view block) { writer.writeBlock(block); });
+        writer.flush();
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur: " << e.what() << std::endl;
+    }
+}
+
+// faidx : écrit l'index .fai de la référence, puis affiche les régions demandées
+// (nom, ou nom:début-fin à partir de 1, bornes incluses, comme samtools faidx)
+int faidx(int argc, char* argv[]) {
+    try {
+        FastaParser parser(argv[2]);
+        parser.writeIndex();
+        for (int i = 3; i < argc; ++i) {
+            const std::string region = argv[i];
+            std::string contig = region;
+            std::size_t start = 0, end = std::string::npos;
+            const std::size_t colon = region.rfind(':');
+            if (colon != std::string::npos && !parser.loadIndex().contains(region)) {
+                contig = region.substr(0, colon);
+                const std::string range = region.substr(colon + 1);
+                const std::size_t dash = range.find('-');
+                start = std::stoul(range.substr(0, dash)) - 1;
+                if (dash != std::string::npos) end = std::stoul(range.substr(dash + 1));
+            }
+            const std::string bases = parser.fetch(contig, start, end);
+            std::cout << '>' << region << '\n';
+            for (std::size_t pos = 0; pos < bases.size(); pos += 60) {
+                std::cout << bases.substr(pos, 60) << '\n';
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Erreur: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
-        std::cout << "Usage: " << argv[0] << " <reference.fasta> <reads.(fastq|fasta)> [k=21] [step=1]\n";
+    if (argc > 2 && std::string(argv[1]) == "faidx") {
+        return faidx(argc, argv);
+    }
+
+    // Sous-commandes build-index et paired : les arguments sont décalés d'un ou deux crans
+    bool buildMode = argc > 1 && std::string(argv[1]) == "build-index";
+    bool pairedMode = argc > 1 && std::string(argv[1]) == "paired";
+    int first = buildMode ? 2 : pairedMode ? 3 : 1;
+
+    if (argc < first + 2) {
+        std::cout << "Usage: " << argv[0] << " <reference.(fasta|idx)> <reads.(fastq|fasta)> [k=21] [step=1] [threads=1] [index=sa|fm|hash] [w=0] [max_ed=-1] [max_occ=0] [sam]\n";
+        std::cout << "       " << argv[0] << " paired <reference.(fasta|idx)> <reads_R1.fastq> <reads_R2.fastq> [k=21] [step=1] [threads=1] [index=sa|fm|hash] [w=0] [max_ed=-1] [max_occ=0] [sam]\n";
+        std::cout << "       " << argv[0] << " build-index <reference.fasta> <index.idx> [k=21] [step=1] [threads=1] [index=sa|fm|hash] [w=0] [max_occ=0] [sa_build=sais|doubling]\n";
+        std::cout << "       " << argv[0] << " faidx <reference.fasta> [région (nom ou nom:début-fin)]...\n";
         std::cout <<"Exemple d'éxécusion  : ./executable genome.fasta reads.fastq taille_kmer pas \n" << std::endl;
         return 1;
     }
     
-    int k = argc > 3 ? std::stoi(argv[3]) : 21;
-    int step = argc > 4 ? std::stoi(argv[4]) : 1;
+    int k = argc > first + 2 ? std::stoi(argv[first + 2]) : 21;
+    int step = argc > first + 3 ? std::stoi(argv[first + 3]) : 1;
+    int threads = argc > first + 4 ? std::stoi(argv[first + 4]) : 1;
+    std::string engine = argc > first + 5 ? argv[first + 5] : "sa";
+    int window = argc > first + 6 ? std::stoi(argv[first + 6]) : 0;
+    // build-index n'a pas de max_ed : max_occ suit directement w
+    int maxEditDistance = !buildMode && argc > first + 7 ? std::stoi(argv[first + 7]) : ReadMapper::NO_EDIT_DISTANCE_LIMIT;
+    const int occurrenceArg = buildMode ? first + 7 : first + 8;
+    int maxOccurrences = argc > occurrenceArg ? std::stoi(argv[occurrenceArg]) : 0;
+    std::string samFile = !buildMode && argc > first + 9 ? argv[first + 9] : "";
+    // build-index seulement : méthode de construction de la table des suffixes après max_occ
+    std::string saBuild = buildMode && argc > first + 8 ? argv[first + 8] : "sais";
+    // SAM sur la sortie standard : les messages passent sur la sortie d'erreur
+    std::ostream& log = samFile == "-" ? std::cerr : std::cout;
 
     // Validation des paramètres
-    if (k <= 0 || step <= 0) {
-        std::cerr << "Erreur: k et step doivent être > 0\n";
+    if (k <= 0 || step <= 0 || threads <= 0 || window < 0 || maxOccurrences < 0) {
+        std::cerr << "Erreur: k, step et threads doivent être > 0, w et max_occ ≥ 0\n";
+        return 1;
+    }
+    if (engine != "sa" && engine != "fm" && engine != "hash") {
+        std::cerr << "Erreur: index doit valoir sa, fm ou hash\n";
+        return 1;
+    }
+    if (saBuild != "sais" && saBuild != "doubling") {
+        std::cerr << "Erreur: sa_build doit valoir sais ou doubling\n";
         return 1;
     }
     
-    std::cout << "Paramètres:\n";
-    std::cout << " - Taille k-mer: " << k << "\n";
-    std::cout << " - Pas: " << step << "\n\n";
+    log << "Paramètres:\n";
+    log << " - Taille k-mer: " << k << "\n";
+    log << " - Pas: " << step << "\n";
+    log << " - Threads: " << threads << "\n";
+    log << " - Index: " << engine << "\n";
+    log << " - Fenêtre des minimiseurs: " << window << "\n";
+    log << " - Distance d'édition maximale: " << maxEditDistance << "\n";
+    log << " - Occurrences maximales par graine: " << maxOccurrences << "\n\n";
 
-    explainCIGAR();
+    if (buildMode) {
+        return buildIndex(argv[2], argv[3], k, step, threads, engine, window, maxOccurrences,
+                          saBuild == "doubling" ? SuffixArray::BuildMethod::PARALLEL_DOUBLING
+                                                : SuffixArray::BuildMethod::SAIS);
+    }
+    if (samFile.empty()) {
+        explainCIGAR();
+    }
+    if (pairedMode) {
+        processPairedFiles(argv[2], argv[3], argv[4], k, step, threads, engine, window,
+                           maxEditDistance, maxOccurrences, samFile, log);
+        return 0;
+    }
     
     try {
-        processFile(argv[1], argv[2], k, step);
+        processFile(argv[1], argv[2], k, step, threads, engine, window, maxEditDistance, maxOccurrences,
+                    samFile, log);
     } catch (const std::exception& e) {
         std::cerr << "Erreur non gérée: " << e.what() << std::endl;
         return 1;